@@ -0,0 +1,125 @@
+#include <QtWidgets/QApplication>
+#include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QXmlStreamReader>
+#include "CoreBenchmarks.h"
+#include "StorageBenchmarks.h"
+#include <cstdio>
+
+namespace {
+// Collects the BenchmarkResult elements of a QtTest XML log
+bool appendResults(const QString &xmlPath, const QString &suite, QJsonArray *results)
+{
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Failed to read %s\n", qPrintable(xmlPath));
+        return false;
+    }
+    
+    QXmlStreamReader reader(&file);
+    QString function;
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        
+        QXmlStreamAttributes attributes = reader.attributes();
+        if (reader.name() == QLatin1String("TestFunction")) {
+            function = attributes.value("name").toString();
+        } else if (reader.name() == QLatin1String("BenchmarkResult")) {
+            QJsonObject result;
+            result["suite"] = suite;
+            result["function"] = function;
+            result["tag"] = attributes.value("tag").toString();
+            result["metric"] = attributes.value("metric").toString();
+            // Already divided by the iteration count
+            result["value"] = attributes.value("value").toDouble();
+            result["iterations"] = attributes.value("iterations").toInt();
+            results->append(result);
+        }
+    }
+    
+    if (reader.hasError()) {
+        fprintf(stderr, "Failed to parse %s: %s\n", qPrintable(xmlPath), qPrintable(reader.errorString()));
+        return false;
+    }
+    return true;
+}
+}
+
+// Runs every benchmark suite. Arguments are passed on to QtTest, plus:
+//   --suite <name>  run only CoreBenchmarks or StorageBenchmarks
+//   --json <path>   also write all results to a JSON file for comparison
+int main(int argc, char *argv[])
+{
+    // The tree and highlighter benchmarks need a GUI application, not a display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    
+    QApplication app(argc, argv);
+    app.setApplicationName("API Tester Benchmarks");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("ApiTester");
+    app.setOrganizationDomain("apitester.com");
+    
+    // Keep the benchmark's settings and data away from the real application
+    QStandardPaths::setTestModeEnabled(true);
+    
+    QStringList arguments = app.arguments();
+    auto takeOption = [&arguments](const QString &option) {
+        QString value;
+        int index = arguments.indexOf(option);
+        if (index > 0 && index + 1 < arguments.size()) {
+            value = arguments.at(index + 1);
+            arguments.erase(arguments.begin() + index, arguments.begin() + index + 2);
+        }
+        return value;
+    };
+    QString jsonPath = takeOption("--json");
+    QString suiteName = takeOption("--suite");
+    
+    CoreBenchmarks coreBenchmarks;
+    StorageBenchmarks storageBenchmarks;
+    
+    QTemporaryDir logDirectory;
+    QJsonArray results;
+    int failures = 0;
+    for (QObject *suite : QList<QObject*>{&coreBenchmarks, &storageBenchmarks}) {
+        QString name = suite->metaObject()->className();
+        if (!suiteName.isEmpty() && suiteName != name) {
+            continue;
+        }
+        
+        QStringList suiteArguments = arguments;
+        QString xmlPath;
+        if (!jsonPath.isEmpty()) {
+            xmlPath = logDirectory.filePath(name + ".xml");
+            suiteArguments << "-o" << xmlPath + ",xml" << "-o" << "-,txt";
+        }
+        
+        failures += QTest::qExec(suite, suiteArguments);
+        
+        if (!xmlPath.isEmpty() && !appendResults(xmlPath, name, &results)) {
+            ++failures;
+        }
+    }
+    
+    if (!jsonPath.isEmpty()) {
+        QJsonObject root;
+        root["version"] = app.applicationVersion();
+        root["qtVersion"] = QString(qVersion());
+        root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        root["results"] = results;
+        
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fprintf(stderr, "Failed to write %s: %s\n", qPrintable(jsonPath), qPrintable(file.errorString()));
+            return 1;
+        }
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    }
+    
+    return failures;
+}
\ No newline at end of file
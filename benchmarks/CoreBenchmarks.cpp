@@ -0,0 +1,131 @@
+#include "CoreBenchmarks.h"
+#include "RegexJsonHighlighter.h"
+#include "RequestExecutor.h"
+#include "ResponseProcessor.h"
+#include "JsonTreeModel.h"
+#include "SyntaxHighlighter.h"
+#include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+
+QString CoreBenchmarks::sampleJson(int itemCount)
+{
+    QJsonArray items;
+    for (int i = 0; i < itemCount; ++i) {
+        QJsonObject item;
+        item["id"] = i;
+        item["name"] = QString("Item %1").arg(i);
+        item["price"] = i * 1.25;
+        item["active"] = i % 2 == 0;
+        item["parent"] = QJsonValue::Null;
+        item["tags"] = QJsonArray({"alpha", "beta", "gamma"});
+        item["owner"] = QJsonObject({{"id", i % 97}, {"email", QString("user%1@example.com").arg(i % 97)}});
+        items.append(item);
+    }
+    return QString::fromUtf8(QJsonDocument(items).toJson(QJsonDocument::Indented));
+}
+
+void CoreBenchmarks::createRequest_data()
+{
+    QTest::addColumn<HttpHeaders>("headers");
+    
+    for (int count : {0, 10, 50}) {
+        HttpHeaders headers;
+        for (int i = 0; i < count; ++i) {
+            headers.append(QString("X-Custom-Header-%1").arg(i).toUtf8(),
+                           QString("value-%1; q=0.%2").arg(i).arg(i % 10).toUtf8());
+        }
+        QTest::newRow(qPrintable(QString("%1 headers").arg(count))) << headers;
+    }
+}
+
+void CoreBenchmarks::createRequest()
+{
+    QFETCH(HttpHeaders, headers);
+    const QString url = "https://api.example.com/v1/items?page=2&limit=50";
+    
+    QBENCHMARK {
+        QNetworkRequest request = RequestExecutor::createRequest(url, headers);
+        Q_UNUSED(request);
+    }
+}
+
+void CoreBenchmarks::processResponse_data()
+{
+    QTest::addColumn<QString>("response");
+    
+    QTest::newRow("10 items") << sampleJson(10);
+    QTest::newRow("1000 items") << sampleJson(1000);
+    QTest::newRow("50000 items") << sampleJson(50000);
+}
+
+void CoreBenchmarks::processResponse()
+{
+    QFETCH(QString, response);
+    QByteArray body = response.toUtf8();
+    
+    ResponseProcessor processor;
+    ProcessedResponse result;
+    connect(&processor, &ResponseProcessor::finished, this, [&result](const ProcessedResponse &processed) {
+        result = processed;
+    });
+    
+    QBENCHMARK {
+        processor.process(1, body);
+    }
+    QVERIFY(result.isJson);
+}
+
+void CoreBenchmarks::buildJsonTree_data()
+{
+    processResponse_data();
+}
+
+void CoreBenchmarks::buildJsonTree()
+{
+    QFETCH(QString, response);
+    QJsonDocument document = QJsonDocument::fromJson(response.toUtf8());
+    JsonTreeModel model;
+    
+    // What the response view does: reset the model, then expand the document
+    QBENCHMARK {
+        model.setDocument(document);
+        QModelIndex root = model.index(0, 0);
+        if (model.canFetchMore(root)) {
+            model.fetchMore(root);
+        }
+    }
+    QVERIFY(model.rowCount(model.index(0, 0)) > 0);
+}
+
+void CoreBenchmarks::highlightJson_data()
+{
+    QTest::addColumn<bool>("regex");
+    QTest::addColumn<QString>("text");
+    
+    QString small = sampleJson(100);
+    QString large = sampleJson(5000);
+    QTest::newRow("lexer, 100 items") << false << small;
+    QTest::newRow("regex, 100 items") << true << small;
+    QTest::newRow("lexer, 5000 items") << false << large;
+    QTest::newRow("regex, 5000 items") << true << large;
+}
+
+void CoreBenchmarks::highlightJson()
+{
+    QFETCH(bool, regex);
+    QFETCH(QString, text);
+    
+    QTextDocument document(text);
+    QScopedPointer<QSyntaxHighlighter> highlighter;
+    if (regex) {
+        highlighter.reset(new RegexJsonHighlighter(&document));
+    } else {
+        highlighter.reset(new JsonSyntaxHighlighter(&document));
+    }
+    
+    QBENCHMARK {
+        highlighter->rehighlight();
+    }
+}
\ No newline at end of file
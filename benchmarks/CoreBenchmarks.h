@@ -0,0 +1,27 @@
+#ifndef COREBENCHMARKS_H
+#define COREBENCHMARKS_H
+
+#include <QtCore/QObject>
+
+// Micro benchmarks for the per-request hot paths: building requests and
+// preparing, modelling and highlighting response bodies.
+class CoreBenchmarks : public QObject
+{
+    Q_OBJECT
+    
+public:
+    // A pretty-printed JSON array of itemCount objects of mixed value types
+    static QString sampleJson(int itemCount);
+    
+private slots:
+    void createRequest_data();
+    void createRequest();
+    void processResponse_data();
+    void processResponse();
+    void buildJsonTree_data();
+    void buildJsonTree();
+    void highlightJson_data();
+    void highlightJson();
+};
+
+#endif // COREBENCHMARKS_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "RegexJsonHighlighter.h"
+#include <QtGui/QColor>
+
+RegexJsonHighlighter::RegexJsonHighlighter(QTextDocument *parent)
+    : QSyntaxHighlighter(parent)
+{
+    HighlightingRule rule;
+    
+    // Keys (quoted strings followed by colon)
+    rule.format.setForeground(QColor(86, 156, 214));
+    rule.format.setFontWeight(QFont::Bold);
+    rule.pattern = QRegularExpression(QStringLiteral("\"[^\"]*\"(?=\\s*:)"));
+    highlightingRules.append(rule);
+    
+    // String values
+    rule.format = QTextCharFormat();
+    rule.format.setForeground(QColor(206, 145, 120));
+    rule.pattern = QRegularExpression(QStringLiteral("(?<=:)\\s*\"[^\"]*\""));
+    highlightingRules.append(rule);
+    
+    // Numbers
+    rule.format = QTextCharFormat();
+    rule.format.setForeground(QColor(181, 206, 168));
+    rule.pattern = QRegularExpression(QStringLiteral("\\b[+-]?\\d+(?:\\.\\d+)?(?:[eE][+-]?\\d+)?\\b"));
+    highlightingRules.append(rule);
+    
+    // Booleans
+    rule.format = QTextCharFormat();
+    rule.format.setForeground(QColor(86, 156, 214));
+    rule.format.setFontWeight(QFont::Bold);
+    rule.pattern = QRegularExpression(QStringLiteral("\\b(true|false)\\b"));
+    highlightingRules.append(rule);
+    
+    // null
+    rule.format = QTextCharFormat();
+    rule.format.setForeground(QColor(156, 156, 156));
+    rule.format.setFontWeight(QFont::Bold);
+    rule.pattern = QRegularExpression(QStringLiteral("\\bnull\\b"));
+    highlightingRules.append(rule);
+    
+    // Punctuation
+    rule.format = QTextCharFormat();
+    rule.format.setForeground(QColor(220, 220, 170));
+    rule.pattern = QRegularExpression(QStringLiteral("[{}\\[\\],:]"));
+    highlightingRules.append(rule);
+}
+
+void RegexJsonHighlighter::highlightBlock(const QString &text)
+{
+    for (const HighlightingRule &rule : highlightingRules) {
+        QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
+        while (matchIterator.hasNext()) {
+            QRegularExpressionMatch match = matchIterator.next();
+            setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+        }
+    }
+}
\ No newline at end of file
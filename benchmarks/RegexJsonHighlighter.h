@@ -0,0 +1,31 @@
+#ifndef REGEXJSONHIGHLIGHTER_H
+#define REGEXJSONHIGHLIGHTER_H
+
+#include <QtGui/QSyntaxHighlighter>
+#include <QtGui/QTextDocument>
+#include <QtGui/QTextCharFormat>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QVector>
+
+// The regular-expression JSON highlighter the application used before the
+// single-pass lexer, kept as the baseline for the highlighting benchmark.
+class RegexJsonHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+    
+public:
+    explicit RegexJsonHighlighter(QTextDocument *parent = nullptr);
+    
+protected:
+    void highlightBlock(const QString &text) override;
+    
+private:
+    struct HighlightingRule
+    {
+        QRegularExpression pattern;
+        QTextCharFormat format;
+    };
+    QVector<HighlightingRule> highlightingRules;
+};
+
+#endif // REGEXJSONHIGHLIGHTER_H
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "StorageBenchmarks.h"
+#include "CoreBenchmarks.h"
+#include "DatabaseManager.h"
+#include "HistoryWriter.h"
+#include "ResponseBlobStore.h"
+#include "CollectionManager.h"
+#include <QtTest/QtTest>
+#include <QtCore/QDateTime>
+#include <QtCore/QRandomGenerator>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+namespace {
+const char *ConnectionName = "BenchmarkConnection";
+
+StorageProfile profileNamed(const QString &name)
+{
+    return name == "legacy" ? StorageProfile::legacy() : StorageProfile();
+}
+
+// A fixed pool of distinct entries; repeated responses are deduplicated by
+// the blob store just as repeated calls to one endpoint are
+QVector<HistoryEntry> sampleEntries(int count)
+{
+    static QVector<HistoryEntry> pool;
+    if (pool.isEmpty()) {
+        for (int i = 0; i < 64; ++i) {
+            HistoryEntry entry;
+            entry.method = i % 4 == 0 ? "POST" : "GET";
+            entry.url = QString("https://api.example.com/v1/items/%1").arg(i);
+            entry.headers = HttpHeaders::fromText("Accept: application/json\nAuthorization: Bearer token").toJson();
+            entry.body = entry.method == "POST" ? "{\"name\": \"item\"}" : QString();
+            entry.response = CoreBenchmarks::sampleJson(10 + i).toUtf8();
+            entry.statusCode = 200;
+            entry.responseTime = 40 + i;
+            entry.createdAt = QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd HH:mm:ss");
+            pool.append(entry);
+        }
+    }
+    
+    QVector<HistoryEntry> entries;
+    entries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        entries.append(pool.at(i % pool.size()));
+    }
+    return entries;
+}
+}
+
+void StorageBenchmarks::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+    
+    // Let the application create and migrate the schema once, then copy it
+    QVERIFY(DatabaseManager::instance().initialize(m_directory.filePath("template")));
+    m_templatePath = DatabaseManager::instance().getCurrentDatabasePath();
+    QSqlQuery checkpoint(DatabaseManager::instance().database());
+    QVERIFY(checkpoint.exec("PRAGMA wal_checkpoint(TRUNCATE)"));
+}
+
+void StorageBenchmarks::cleanupTestCase()
+{
+    DatabaseManager::instance().drainHistory();
+}
+
+QString StorageBenchmarks::createDatabase(const QString &name)
+{
+    QString directory = m_directory.filePath(name);
+    QDir().mkpath(directory);
+    
+    QString path = directory + "/apitester.db";
+    QFile::remove(path);
+    if (!QFile::copy(m_templatePath, path)) {
+        qWarning() << "Failed to copy the benchmark database to" << path;
+    }
+    return path;
+}
+
+QSqlDatabase StorageBenchmarks::openDatabase(const QString &path, const StorageProfile &profile)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+    database.setDatabaseName(path);
+    if (!database.open() || !profile.apply(database)) {
+        qWarning() << "Failed to open benchmark database:" << database.lastError().text();
+    }
+    return database;
+}
+
+void StorageBenchmarks::closeDatabase()
+{
+    {
+        QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+}
+
+void StorageBenchmarks::insertHistory_data()
+{
+    QTest::addColumn<QString>("profile");
+    QTest::addColumn<int>("batchSize");
+    
+    for (const QString &profile : {QString("legacy"), QString("default")}) {
+        for (int batchSize : {1, 64}) {
+            QTest::newRow(qPrintable(QString("%1, batch %2").arg(profile).arg(batchSize))) << profile << batchSize;
+        }
+    }
+}
+
+void StorageBenchmarks::insertHistory()
+{
+    QFETCH(QString, profile);
+    QFETCH(int, batchSize);
+    
+    QString path = createDatabase(QString("insert-%1-%2").arg(profile).arg(batchSize));
+    QVector<HistoryEntry> entries = sampleEntries(batchSize);
+    {
+        QSqlDatabase database = openDatabase(path, profileNamed(profile));
+        
+        // One iteration is one committed batch
+        QBENCHMARK {
+            QVERIFY(HistoryWriter::writeEntries(database, entries));
+        }
+    }
+    closeDatabase();
+}
+
+void StorageBenchmarks::lookupHistory_data()
+{
+    QTest::addColumn<QString>("profile");
+    
+    QTest::newRow("legacy") << QString("legacy");
+    QTest::newRow("default") << QString("default");
+}
+
+void StorageBenchmarks::lookupHistory()
+{
+    QFETCH(QString, profile);
+    const int entryCount = 5000;
+    const int lookups = 200;
+    
+    QString path = createDatabase(QString("lookup-%1").arg(profile));
+    {
+        QSqlDatabase database = openDatabase(path, profileNamed(profile));
+        QVERIFY(HistoryWriter::writeEntries(database, sampleEntries(entryCount)));
+        
+        QSqlQuery query(database);
+        query.prepare("SELECT method, url, headers, body, response_blob_id FROM history WHERE id = ?");
+        
+        // Opening a history entry: the request row, then its response blob
+        QRandomGenerator random(42);
+        QBENCHMARK {
+            for (int i = 0; i < lookups; ++i) {
+                query.addBindValue(random.bounded(1, entryCount + 1));
+                QVERIFY(query.exec() && query.next());
+                QVERIFY(!ResponseBlobStore::load(database, query.value(4).toLongLong()).isEmpty());
+                query.finish();
+            }
+        }
+    }
+    closeDatabase();
+}
+
+QString StorageBenchmarks::collectionDatabase(int collections, int requestsPerCollection)
+{
+    QString name = QString("collections-%1x%2").arg(collections).arg(requestsPerCollection);
+    QString directory = m_directory.filePath(name);
+    if (QFile::exists(directory + "/apitester.db")) {
+        return directory;
+    }
+    
+    QString path = createDatabase(name);
+    {
+        QSqlDatabase database = openDatabase(path, StorageProfile());
+        database.transaction();
+        
+        QSqlQuery insertCollection(database);
+        insertCollection.prepare("INSERT INTO collections (name, description) VALUES (?, ?)");
+        QSqlQuery insertRequest(database);
+        insertRequest.prepare("INSERT INTO requests (collection_id, name, method, url, headers, body) "
+                              "VALUES (?, ?, ?, ?, '', '')");
+        
+        static const char *methods[] = {"GET", "POST", "PUT", "DELETE"};
+        for (int c = 0; c < collections; ++c) {
+            insertCollection.addBindValue(QString("Collection %1").arg(c, 5, 10, QChar('0')));
+            insertCollection.addBindValue(QString("Benchmark collection %1").arg(c));
+            if (!insertCollection.exec()) {
+                qWarning() << "Failed to insert collection:" << insertCollection.lastError().text();
+                break;
+            }
+            
+            qint64 collectionId = insertCollection.lastInsertId().toLongLong();
+            for (int r = 0; r < requestsPerCollection; ++r) {
+                insertRequest.addBindValue(collectionId);
+                insertRequest.addBindValue(QString("Request %1").arg(r, 3, 10, QChar('0')));
+                insertRequest.addBindValue(methods[r % 4]);
+                insertRequest.addBindValue(QString("https://api.example.com/v1/collections/%1/items/%2").arg(c).arg(r));
+                insertRequest.exec();
+            }
+        }
+        
+        database.commit();
+    }
+    closeDatabase();
+    return directory;
+}
+
+void StorageBenchmarks::collectionQuery_data()
+{
+    QTest::addColumn<bool>("joined");
+    QTest::addColumn<int>("collections");
+    
+    QTest::newRow("per collection, 1000x20") << false << 1000;
+    QTest::newRow("joined, 1000x20") << true << 1000;
+    QTest::newRow("per collection, 10000x20") << false << 10000;
+    QTest::newRow("joined, 10000x20") << true << 10000;
+}
+
+void StorageBenchmarks::collectionQuery()
+{
+    QFETCH(bool, joined);
+    QFETCH(int, collections);
+    
+    QString directory = collectionDatabase(collections, 20);
+    int rows = 0;
+    {
+        QSqlDatabase database = openDatabase(directory + "/apitester.db", StorageProfile());
+        
+        // The SQL side of loadCollections without the tree; the per-collection
+        // variant is how the tree used to be loaded
+        QBENCHMARK {
+            rows = 0;
+            QSqlQuery query(database);
+            query.setForwardOnly(true);
+            if (joined) {
+                QVERIFY(query.exec("SELECT c.id, c.name, c.description, r.id, r.name, r.method, r.url "
+                                   "FROM collections c LEFT JOIN requests r ON r.collection_id = c.id "
+                                   "ORDER BY c.name, c.id, r.name"));
+                while (query.next()) {
+                    if (!query.isNull(3)) {
+                        ++rows;
+                    }
+                }
+            } else {
+                QVERIFY(query.exec("SELECT id, name, description FROM collections ORDER BY name"));
+                QSqlQuery requests(database);
+                requests.setForwardOnly(true);
+                requests.prepare("SELECT id, name, method, url FROM requests WHERE collection_id = ? ORDER BY name");
+                while (query.next()) {
+                    requests.addBindValue(query.value(0));
+                    QVERIFY(requests.exec());
+                    while (requests.next()) {
+                        ++rows;
+                    }
+                }
+            }
+        }
+    }
+    closeDatabase();
+    QCOMPARE(rows, collections * 20);
+}
+
+void StorageBenchmarks::loadCollections_data()
+{
+    QTest::addColumn<int>("collections");
+    
+    QTest::newRow("100x20") << 100;
+    QTest::newRow("1000x20") << 1000;
+    QTest::newRow("10000x20") << 10000;
+}
+
+void StorageBenchmarks::loadCollections()
+{
+    QFETCH(int, collections);
+    
+    QVERIFY(DatabaseManager::instance().initialize(collectionDatabase(collections, 20)));
+    CollectionManager manager;
+    
+    QBENCHMARK {
+        manager.loadCollections();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef STORAGEBENCHMARKS_H
+#define STORAGEBENCHMARKS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
+#include <QtSql/QSqlDatabase>
+#include "StorageProfile.h"
+
+// Macro benchmarks against real SQLite files: history writes and lookups
+// under the legacy and default storage profiles, and loading the collection
+// tree from large databases.
+class StorageBenchmarks : public QObject
+{
+    Q_OBJECT
+    
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void insertHistory_data();
+    void insertHistory();
+    void lookupHistory_data();
+    void lookupHistory();
+    void collectionQuery_data();
+    void collectionQuery();
+    void loadCollections_data();
+    void loadCollections();
+    
+private:
+    // A fresh copy of the migrated schema in its own directory
+    QString createDatabase(const QString &name);
+    // Directory holding a database with the given number of collections and
+    // requests per collection; created on first use
+    QString collectionDatabase(int collections, int requestsPerCollection);
+    QSqlDatabase openDatabase(const QString &path, const StorageProfile &profile);
+    void closeDatabase();
+    
+    QTemporaryDir m_directory;
+    QString m_templatePath;
+};
+
+#endif // STORAGEBENCHMARKS_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QSettings>
+#include <QtCore/QThread>
+#include "CliRunner.h"
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    // Same identity as the GUI so the default database location matches
+    app.setApplicationName("API Tester");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("ApiTester");
+    app.setOrganizationDomain("apitester.com");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs API Tester collections and test suites without a display.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QCommandLineOption databaseOption({"d", "database"}, "SQLite database to read collections from.", "path");
+    QCommandLineOption collectionOption({"c", "collection"}, "Collection name or id to run.", "collection");
+    QCommandLineOption fileOption({"f", "file"}, "JSON test suite to run instead of a collection.", "path");
+    QCommandLineOption listOption({"l", "list"}, "List the collections in the database and exit.");
+    QCommandLineOption parallelOption({"p", "parallel"}, "Number of requests kept in flight.", "count",
+                                      QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outputOption({"o", "output"}, "Write results to this file instead of stdout.", "path");
+    QCommandLineOption formatOption("format", "Result format: json or junit.", "format", "json");
+    QCommandLineOption timeoutOption({"t", "timeout"}, "Seconds before a test times out (0 = never).", "seconds", "30");
+    QCommandLineOption suiteTimeoutOption("suite-timeout", "Seconds before the whole run times out (0 = never).",
+                                          "seconds", "0");
+    QCommandLineOption retriesOption({"r", "retries"}, "Times a test is retried after a transient failure.",
+                                     "count", "0");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Print each test result to stderr as it completes.");
+    parser.addOptions({databaseOption, collectionOption, fileOption, listOption, parallelOption,
+                       timeoutOption, suiteTimeoutOption, retriesOption, outputOption, formatOption,
+                       verboseOption});
+    parser.process(app);
+    
+    // Default to the database the GUI is using
+    QString databasePath = parser.value(databaseOption);
+    if (databasePath.isEmpty()) {
+        QSettings settings;
+        QString directory = settings.value("database/path").toString();
+        if (directory.isEmpty()) {
+            directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        }
+        databasePath = directory + "/apitester.db";
+    }
+    
+    if (parser.isSet(listOption)) {
+        return CliRunner::listCollections(databasePath) ? CliRunner::AllPassed : CliRunner::UsageError;
+    }
+    
+    QString format = parser.value(formatOption).toLower();
+    if (format != "json" && format != "junit") {
+        fprintf(stderr, "Unknown format: %s\n", qPrintable(format));
+        return CliRunner::UsageError;
+    }
+    
+    CliRunner runner;
+    bool loaded = false;
+    if (parser.isSet(fileOption)) {
+        loaded = runner.loadFromFile(parser.value(fileOption));
+    } else if (parser.isSet(collectionOption)) {
+        loaded = runner.loadFromDatabase(databasePath, parser.value(collectionOption));
+    } else {
+        fprintf(stderr, "Specify --collection or --file.\n\n%s", qPrintable(parser.helpText()));
+        return CliRunner::UsageError;
+    }
+    
+    if (!loaded) {
+        fprintf(stderr, "%s\n", qPrintable(runner.errorString()));
+        return CliRunner::UsageError;
+    }
+    
+    runner.setOutput(parser.value(outputOption), format);
+    runner.setVerbose(parser.isSet(verboseOption));
+    runner.setRetryPolicy(RetryPolicy::withAttempts(qMax(0, parser.value(retriesOption).toInt()) + 1));
+    runner.setTimeouts(parser.value(timeoutOption).toInt() * 1000, parser.value(suiteTimeoutOption).toInt() * 1000);
+    // Queued: an empty suite finishes inside run(), before exec() has started
+    // the event loop, and exit() does nothing without one
+    QObject::connect(&runner, &CliRunner::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+    
+    runner.run(qMax(1, parser.value(parallelOption).toInt()));
+    return app.exec();
+}
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "CliRunner.h"
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
+#include <QtCore/QXmlStreamWriter>
+#include <QtCore/QTextStream>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+#include <cstdio>
+
+namespace {
+const char *ConnectionName = "CliConnection";
+
+// Read-only so the runner never migrates or locks the GUI's database
+bool openReadOnly(QSqlDatabase &database, const QString &databasePath, QString *errorString)
+{
+    if (!QFile::exists(databasePath)) {
+        *errorString = QString("Database not found: %1").arg(databasePath);
+        return false;
+    }
+    
+    database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+    database.setDatabaseName(databasePath);
+    database.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (!database.open()) {
+        *errorString = QString("Failed to open database: %1").arg(database.lastError().text());
+        return false;
+    }
+    return true;
+}
+
+QString statusName(TestCase::Status status)
+{
+    switch (status) {
+    case TestCase::Passed:
+        return "passed";
+    case TestCase::Failed:
+        return "failed";
+    case TestCase::Running:
+        return "running";
+    case TestCase::TimedOut:
+        return "timedOut";
+    case TestCase::Cancelled:
+        return "cancelled";
+    default:
+        return "notRun";
+    }
+}
+}
+
+CliRunner::CliRunner(QObject *parent)
+    : QObject(parent)
+    , m_runner(new TestRunner(this))
+    , m_format("json")
+    , m_verbose(false)
+{
+    connect(m_runner, &TestRunner::testCompleted, this, &CliRunner::onTestCompleted);
+    connect(m_runner, &TestRunner::allTestsCompleted, this, &CliRunner::onAllTestsCompleted);
+}
+
+bool CliRunner::loadFromDatabase(const QString &databasePath, const QString &collection)
+{
+    bool loaded = false;
+    {
+        QSqlDatabase database;
+        if (!openReadOnly(database, databasePath, &m_errorString)) {
+            return false;
+        }
+        
+        QSqlQuery query(database);
+        bool isId = false;
+        int collectionId = collection.toInt(&isId);
+        query.prepare(isId ? "SELECT id, name FROM collections WHERE id = ?"
+                           : "SELECT id, name FROM collections WHERE name = ? ORDER BY id LIMIT 1");
+        query.addBindValue(isId ? QVariant(collectionId) : QVariant(collection));
+        
+        if (!query.exec() || !query.next()) {
+            m_errorString = QString("Collection not found: %1").arg(collection);
+        } else {
+            collectionId = query.value(0).toInt();
+            m_suiteName = query.value(1).toString();
+            
+            query.prepare("SELECT id, name, method, url, headers, body, parameters FROM requests "
+                          "WHERE collection_id = ? ORDER BY name");
+            query.addBindValue(collectionId);
+            if (!query.exec()) {
+                m_errorString = QString("Failed to load requests: %1").arg(query.lastError().text());
+            } else {
+                while (query.next()) {
+                    TestCase testCase;
+                    testCase.id = query.value(0).toInt();
+                    testCase.name = query.value(1).toString();
+                    testCase.method = query.value(2).toString();
+                    testCase.url = query.value(3).toString();
+                    testCase.headers = HttpHeaders::fromStored(query.value(4).toString());
+                    testCase.body = query.value(5).toString();
+                    testCase.expectedStatusCode = "200";
+                    
+                    // Saved parameters are kept apart from the URL; like the
+                    // request panel, only GET requests carry them
+                    QString parameters = query.value(6).toString();
+                    if (!parameters.isEmpty() && testCase.method == "GET") {
+                        testCase.url += (testCase.url.contains('?') ? "&" : "?") + parameters;
+                    }
+                    
+                    m_runner->addTest(testCase);
+                }
+                loaded = true;
+            }
+        }
+        
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+    return loaded;
+}
+
+bool CliRunner::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("Failed to open %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        m_errorString = QString("Invalid test file %1: %2").arg(path, error.errorString());
+        return false;
+    }
+    
+    QJsonArray tests;
+    if (document.isArray()) {
+        tests = document.array();
+        m_suiteName = path;
+    } else {
+        tests = document.object().value("tests").toArray();
+        m_suiteName = document.object().value("name").toString(path);
+    }
+    
+    for (int i = 0; i < tests.size(); ++i) {
+        m_runner->addTest(testFromJson(tests.at(i).toObject(), i + 1));
+    }
+    return true;
+}
+
+TestCase CliRunner::testFromJson(const QJsonObject &obj, int id)
+{
+    TestCase testCase;
+    testCase.id = id;
+    testCase.url = obj.value("url").toString();
+    testCase.name = obj.value("name").toString(testCase.url);
+    testCase.method = obj.value("method").toString("GET").toUpper();
+    
+    // Headers may be given as "Name: value" lines or as an object
+    QJsonValue headers = obj.value("headers");
+    if (headers.isObject()) {
+        const QJsonObject headerObject = headers.toObject();
+        for (auto it = headerObject.begin(); it != headerObject.end(); ++it) {
+            testCase.headers.append(it.key().toUtf8(), it.value().toString().toUtf8());
+        }
+    } else {
+        testCase.headers = HttpHeaders::fromText(headers.toString());
+    }
+    
+    // A JSON body can be inlined as a value instead of an escaped string
+    QJsonValue body = obj.value("body");
+    if (body.isObject()) {
+        testCase.body = QString::fromUtf8(QJsonDocument(body.toObject()).toJson(QJsonDocument::Compact));
+    } else if (body.isArray()) {
+        testCase.body = QString::fromUtf8(QJsonDocument(body.toArray()).toJson(QJsonDocument::Compact));
+    } else {
+        testCase.body = body.toString();
+    }
+    
+    QJsonValue expectedStatus = obj.value("expectedStatus");
+    testCase.expectedStatusCode = expectedStatus.isDouble() ? QString::number(expectedStatus.toInt())
+                                                            : expectedStatus.toString("200");
+    testCase.expectedResponse = obj.value("expectedResponse").toString();
+    testCase.timeoutMs = obj.value("timeoutMs").toInt(0);
+    // Retries after the first attempt
+    if (obj.contains("retries")) {
+        testCase.maxAttempts = qMax(0, obj.value("retries").toInt()) + 1;
+    }
+    return testCase;
+}
+
+bool CliRunner::listCollections(const QString &databasePath)
+{
+    QString errorString;
+    bool listed = false;
+    {
+        QSqlDatabase database;
+        if (!openReadOnly(database, databasePath, &errorString)) {
+            fprintf(stderr, "%s\n", qPrintable(errorString));
+            return false;
+        }
+        
+        QSqlQuery query(database);
+        if (query.exec("SELECT c.id, c.name, COUNT(r.id) FROM collections c "
+                       "LEFT JOIN requests r ON r.collection_id = c.id GROUP BY c.id ORDER BY c.name")) {
+            QTextStream out(stdout);
+            while (query.next()) {
+                out << query.value(0).toInt() << '\t' << query.value(1).toString()
+                    << " (" << query.value(2).toInt() << " requests)\n";
+            }
+            listed = true;
+        } else {
+            fprintf(stderr, "Failed to list collections: %s\n", qPrintable(query.lastError().text()));
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+    return listed;
+}
+
+void CliRunner::setOutput(const QString &path, const QString &format)
+{
+    m_outputPath = path;
+    m_format = format.toLower();
+}
+
+void CliRunner::setRetryPolicy(const RetryPolicy &policy)
+{
+    m_runner->setRetryPolicy(policy);
+}
+
+void CliRunner::setTimeouts(int testTimeoutMs, int suiteTimeoutMs)
+{
+    m_runner->setDefaultTimeout(testTimeoutMs);
+    m_runner->setSuiteTimeout(suiteTimeoutMs);
+}
+
+void CliRunner::run(int parallel)
+{
+    m_timer.start();
+    m_runner->setMaxConcurrency(parallel);
+    m_runner->runAllTests();
+}
+
+void CliRunner::onTestCompleted(int testId, bool passed)
+{
+    if (!m_verbose) {
+        return;
+    }
+    
+    TestCase testCase = m_runner->getTest(testId);
+    const char *result = passed ? "PASS" : testCase.status == TestCase::TimedOut ? "TIME"
+                                         : testCase.status == TestCase::Cancelled ? "SKIP" : "FAIL";
+    fprintf(stderr, "%s  %-7s %s (%lld ms)\n", result,
+            qPrintable(testCase.method), qPrintable(testCase.name), (long long)testCase.responseTime);
+}
+
+void CliRunner::onAllTestsCompleted(int totalTests, int passedTests, int failedTests)
+{
+    QByteArray results = m_format == "junit" ? resultsAsJUnit(passedTests, failedTests)
+                                             : resultsAsJson(passedTests, failedTests);
+    
+    if (m_outputPath.isEmpty() || m_outputPath == "-") {
+        fwrite(results.constData(), 1, size_t(results.size()), stdout);
+        fflush(stdout);
+    } else {
+        QFile file(m_outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(results) != results.size()) {
+            fprintf(stderr, "Failed to write results to %s: %s\n",
+                    qPrintable(m_outputPath), qPrintable(file.errorString()));
+            emit finished(UsageError);
+            return;
+        }
+    }
+    
+    fprintf(stderr, "%d tests, %d passed, %d failed in %lld ms\n",
+            totalTests, passedTests, failedTests, (long long)m_timer.elapsed());
+    emit finished(failedTests > 0 ? TestsFailed : AllPassed);
+}
+
+QByteArray CliRunner::resultsAsJson(int passedTests, int failedTests) const
+{
+    QJsonArray tests;
+    const QList<TestCase> testCases = m_runner->getTests();
+    for (const TestCase &testCase : testCases) {
+        QJsonObject obj;
+        obj["id"] = testCase.id;
+        obj["name"] = testCase.name;
+        obj["method"] = testCase.method;
+        obj["url"] = testCase.url;
+        obj["status"] = statusName(testCase.status);
+        obj["statusCode"] = testCase.actualStatusCode.toInt();
+        obj["expectedStatusCode"] = testCase.expectedStatusCode;
+        obj["responseTimeMs"] = testCase.responseTime;
+        obj["attempts"] = testCase.attempts;
+        if (!testCase.errorMessage.isEmpty()) {
+            obj["error"] = testCase.errorMessage;
+        }
+        tests.append(obj);
+    }
+    
+    QJsonObject root;
+    root["suite"] = m_suiteName;
+    root["total"] = testCases.size();
+    root["passed"] = passedTests;
+    root["failed"] = failedTests;
+    root["durationMs"] = m_timer.elapsed();
+    root["tests"] = tests;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray CliRunner::resultsAsJUnit(int passedTests, int failedTests) const
+{
+    Q_UNUSED(passedTests);
+    
+    QByteArray xml;
+    QXmlStreamWriter writer(&xml);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+    
+    const QList<TestCase> testCases = m_runner->getTests();
+    writer.writeStartElement("testsuite");
+    writer.writeAttribute("name", m_suiteName);
+    writer.writeAttribute("tests", QString::number(testCases.size()));
+    writer.writeAttribute("failures", QString::number(failedTests));
+    writer.writeAttribute("time", QString::number(m_timer.elapsed() / 1000.0, 'f', 3));
+    
+    for (const TestCase &testCase : testCases) {
+        writer.writeStartElement("testcase");
+        writer.writeAttribute("classname", m_suiteName);
+        writer.writeAttribute("name", QString("%1 %2").arg(testCase.method, testCase.name));
+        writer.writeAttribute("time", QString::number(testCase.responseTime / 1000.0, 'f', 3));
+        
+        if (testCase.status == TestCase::Failed || testCase.status == TestCase::TimedOut) {
+            writer.writeStartElement("failure");
+            QString message = testCase.errorMessage.isEmpty()
+                ? QString("Expected status %1, got %2").arg(testCase.expectedStatusCode, testCase.actualStatusCode)
+                : testCase.errorMessage;
+            writer.writeAttribute("message", message);
+            writer.writeCharacters(testCase.url);
+            writer.writeEndElement();
+        } else if (testCase.status != TestCase::Passed) {
+            writer.writeEmptyElement("skipped");
+        }
+        
+        writer.writeEndElement();
+    }
+    
+    writer.writeEndElement();
+    writer.writeEndDocument();
+    return xml;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include "TestRunner.h"
+
+// Drives a TestRunner without any widgets, for CI and headless servers.
+// Tests come from a collection in the application database or from a JSON
+// file; results are written as JSON or JUnit XML once the run completes.
+class CliRunner : public QObject
+{
+    Q_OBJECT
+    
+public:
+    enum ExitCode {
+        AllPassed = 0,
+        TestsFailed = 1,
+        UsageError = 2
+    };
+    
+    explicit CliRunner(QObject *parent = nullptr);
+    
+    // collection may be a collection name or id
+    bool loadFromDatabase(const QString &databasePath, const QString &collection);
+    // A JSON array of tests, or an object with "name" and "tests"
+    bool loadFromFile(const QString &path);
+    static bool listCollections(const QString &databasePath);
+    
+    void setOutput(const QString &path, const QString &format);
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+    // Milliseconds; 0 disables the deadline
+    void setTimeouts(int testTimeoutMs, int suiteTimeoutMs);
+    void setRetryPolicy(const RetryPolicy &policy);
+    
+    void run(int parallel);
+    QString errorString() const { return m_errorString; }
+    int testCount() const { return m_runner->getTests().size(); }
+    
+signals:
+    void finished(int exitCode);
+    
+private slots:
+    void onTestCompleted(int testId, bool passed);
+    void onAllTestsCompleted(int totalTests, int passedTests, int failedTests);
+    
+private:
+    static TestCase testFromJson(const QJsonObject &obj, int id);
+    QByteArray resultsAsJson(int passedTests, int failedTests) const;
+    QByteArray resultsAsJUnit(int passedTests, int failedTests) const;
+    
+    TestRunner *m_runner;
+    QElapsedTimer m_timer;
+    QString m_suiteName;
+    QString m_outputPath;
+    QString m_format;
+    QString m_errorString;
+    bool m_verbose;
+};
+
+#endif // CLIRUNNER_H
\ No newline at end of file
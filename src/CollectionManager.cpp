@@ -1,5 +1,6 @@
 #include "CollectionManager.h"
 #include "DatabaseManager.h"
+#include "ConfigManager.h"
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QLabel>
@@ -8,12 +9,48 @@
 #include <QtWidgets/QTreeWidgetItem>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
+#include <QtCore/QDebug>
 
 CollectionManager::CollectionManager(QWidget *parent)
     : QWidget(parent)
+    , m_requestResultsItem(nullptr)
+    , m_historyResultsItem(nullptr)
+    , m_searchTimer(new QTimer(this))
+    , m_searchThread(new QThread(this))
+    , m_searchWorker(new SearchWorker())
+    , m_searchGeneration(0)
 {
     setupUI();
     loadCollections();
+    
+    // Searches run on their own connection so typing never waits on SQLite
+    qRegisterMetaType<QList<SearchResult>>();
+    m_searchWorker->setStorageProfile(ConfigManager::instance()->getStorageProfile());
+    m_searchWorker->moveToThread(m_searchThread);
+    connect(m_searchThread, &QThread::finished, m_searchWorker, &QObject::deleteLater);
+    connect(this, &CollectionManager::searchRequested, m_searchWorker, &SearchWorker::search);
+    connect(m_searchWorker, &SearchWorker::resultsReady, this, &CollectionManager::onSearchResults);
+    connect(m_searchWorker, &SearchWorker::searchFinished, this, &CollectionManager::onSearchFinished);
+    m_searchThread->start();
+    
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(150);
+    connect(m_searchTimer, &QTimer::timeout, this, &CollectionManager::startSearch);
+    
+    DatabaseManager &database = DatabaseManager::instance();
+    connect(&database, &DatabaseManager::collectionInserted, this, &CollectionManager::onCollectionInserted);
+    connect(&database, &DatabaseManager::collectionUpdated, this, &CollectionManager::onCollectionUpdated);
+    connect(&database, &DatabaseManager::collectionDeleted, this, &CollectionManager::onCollectionDeleted);
+    connect(&database, &DatabaseManager::requestInserted, this, &CollectionManager::onRequestInserted);
+    connect(&database, &DatabaseManager::requestUpdated, this, &CollectionManager::onRequestUpdated);
+    connect(&database, &DatabaseManager::requestDeleted, this, &CollectionManager::onRequestDeleted);
+}
+
+CollectionManager::~CollectionManager()
+{
+    m_searchWorker->setLatestGeneration(0);
+    m_searchThread->quit();
+    m_searchThread->wait();
 }
 
 void CollectionManager::setupUI()
@@ -26,7 +63,12 @@ void CollectionManager::setupUI()
     mainLayout->addWidget(titleLabel);
     
     m_searchEdit = new QLineEdit();
-    m_searchEdit->setPlaceholderText("Search collections...");
+    m_searchEdit->setPlaceholderText("Search requests and history...");
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setEnabled(DatabaseManager::instance().isFullTextSearchAvailable());
+    connect(&DatabaseManager::instance(), &DatabaseManager::fullTextSearchAvailableChanged,
+            m_searchEdit, &QLineEdit::setEnabled);
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &CollectionManager::onSearchTextChanged);
     mainLayout->addWidget(m_searchEdit);
     
     // Buttons
@@ -52,61 +94,263 @@ void CollectionManager::setupUI()
     connect(m_collectionsTree, &QTreeWidget::itemDoubleClicked, 
             this, &CollectionManager::onItemDoubleClicked);
     mainLayout->addWidget(m_collectionsTree);
+    
+    // Search results replace the collections tree while there is search text
+    m_searchResultsTree = new QTreeWidget();
+    m_searchResultsTree->setHeaderLabel("Search Results");
+    m_searchResultsTree->setUniformRowHeights(true);
+    m_searchResultsTree->hide();
+    connect(m_searchResultsTree, &QTreeWidget::itemDoubleClicked, 
+            this, &CollectionManager::onItemDoubleClicked);
+    mainLayout->addWidget(m_searchResultsTree);
 }
 
 void CollectionManager::loadCollections()
 {
     m_collectionsTree->clear();
+    m_collectionItems.clear();
+    m_requestItems.clear();
     
+    // Collections and their requests come back in one pass, grouped by
+    // collection; a collection without requests yields a single row with
+    // NULL request columns
     QSqlQuery query(DatabaseManager::instance().database());
-    if (!query.exec("SELECT id, name, description FROM collections ORDER BY name")) {
+    query.setForwardOnly(true);
+    if (!query.exec(R"(
+        SELECT c.id, c.name, c.description, r.id, r.name, r.method, r.url
+        FROM collections c
+        LEFT JOIN requests r ON r.collection_id = c.id
+        ORDER BY c.name, c.id, r.name
+    )")) {
+        qWarning() << "Failed to load collections:" << query.lastError().text();
         return;
     }
     
+    m_collectionsTree->setUpdatesEnabled(false);
+    
+    QTreeWidgetItem *collectionItem = nullptr;
+    int currentCollectionId = -1;
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
-        QString description = query.value(2).toString();
+        if (!collectionItem || id != currentCollectionId) {
+            QString name = query.value(1).toString();
+            QString description = query.value(2).toString();
+            
+            collectionItem = addCollectionToTree(id, name, description);
+            currentCollectionId = id;
+        }
         
-        addCollectionToTree(id, name, description);
+        if (!query.isNull(3)) {
+            int requestId = query.value(3).toInt();
+            QString requestName = query.value(4).toString();
+            QString method = query.value(5).toString();
+            QString url = query.value(6).toString();
+            
+            addRequestToTree(collectionItem, requestId, requestName, method, url);
+        }
     }
+    
+    m_collectionsTree->expandAll();
+    m_collectionsTree->setUpdatesEnabled(true);
 }
 
-void CollectionManager::addCollectionToTree(int id, const QString &name, const QString &description)
+QTreeWidgetItem *CollectionManager::addCollectionToTree(int id, const QString &name, const QString &description)
 {
     QTreeWidgetItem *collectionItem = new QTreeWidgetItem(m_collectionsTree);
     collectionItem->setText(0, name);
     collectionItem->setData(0, Qt::UserRole, id);
     collectionItem->setData(0, Qt::UserRole + 1, "collection");
+    collectionItem->setData(0, Qt::UserRole + 2, name);
     collectionItem->setToolTip(0, description);
-    
-    // Load requests for this collection
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT id, name, method, url FROM requests WHERE collection_id = ? ORDER BY name");
-    query.addBindValue(id);
-    
-    if (query.exec()) {
-        while (query.next()) {
-            int requestId = query.value(0).toInt();
-            QString requestName = query.value(1).toString();
-            QString method = query.value(2).toString();
-            QString url = query.value(3).toString();
-            
-            addRequestToTree(collectionItem, requestId, requestName, method, url);
+    m_collectionItems.insert(id, collectionItem);
+    return collectionItem;
+}
+
+QTreeWidgetItem *CollectionManager::addRequestToTree(QTreeWidgetItem *parent, int id, const QString &name,
+                                                     const QString &method, const QString &url)
+{
+    QTreeWidgetItem *requestItem = new QTreeWidgetItem(parent);
+    requestItem->setText(0, QString("%1 %2").arg(method, name));
+    requestItem->setData(0, Qt::UserRole, id);
+    requestItem->setData(0, Qt::UserRole + 1, "request");
+    requestItem->setData(0, Qt::UserRole + 2, name);
+    requestItem->setToolTip(0, url);
+    m_requestItems.insert(id, requestItem);
+    return requestItem;
+}
+
+int CollectionManager::sortedRow(QTreeWidgetItem *parent, const QString &name) const
+{
+    // Binary search; siblings are already ordered by name
+    int low = 0;
+    int high = parent ? parent->childCount() : m_collectionsTree->topLevelItemCount();
+    while (low < high) {
+        int middle = (low + high) / 2;
+        QTreeWidgetItem *sibling = parent ? parent->child(middle) : m_collectionsTree->topLevelItem(middle);
+        if (QString::compare(sibling->data(0, Qt::UserRole + 2).toString(), name) <= 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
         }
     }
+    return low;
+}
+
+void CollectionManager::moveToSortedRow(QTreeWidgetItem *item)
+{
+    QTreeWidgetItem *parent = item->parent();
+    bool wasExpanded = item->isExpanded();
+    bool wasCurrent = m_collectionsTree->currentItem() == item;
+    
+    if (parent) {
+        parent->takeChild(parent->indexOfChild(item));
+        parent->insertChild(sortedRow(parent, item->data(0, Qt::UserRole + 2).toString()), item);
+    } else {
+        m_collectionsTree->takeTopLevelItem(m_collectionsTree->indexOfTopLevelItem(item));
+        m_collectionsTree->insertTopLevelItem(sortedRow(nullptr, item->data(0, Qt::UserRole + 2).toString()), item);
+    }
     
+    item->setExpanded(wasExpanded);
+    if (wasCurrent) {
+        m_collectionsTree->setCurrentItem(item);
+    }
+}
+
+void CollectionManager::onCollectionInserted(int collectionId, const QString &name, const QString &description)
+{
+    if (m_collectionItems.contains(collectionId)) {
+        return;
+    }
+    
+    QTreeWidgetItem *collectionItem = addCollectionToTree(collectionId, name, description);
+    moveToSortedRow(collectionItem);
     collectionItem->setExpanded(true);
 }
 
-void CollectionManager::addRequestToTree(QTreeWidgetItem *parent, int id, const QString &name,
-                                       const QString &method, const QString &url)
+void CollectionManager::onCollectionUpdated(int collectionId, const QString &name, const QString &description)
 {
-    QTreeWidgetItem *requestItem = new QTreeWidgetItem(parent);
+    QTreeWidgetItem *collectionItem = m_collectionItems.value(collectionId);
+    if (!collectionItem) {
+        return;
+    }
+    
+    collectionItem->setText(0, name);
+    collectionItem->setToolTip(0, description);
+    if (collectionItem->data(0, Qt::UserRole + 2).toString() != name) {
+        collectionItem->setData(0, Qt::UserRole + 2, name);
+        moveToSortedRow(collectionItem);
+    }
+}
+
+void CollectionManager::onCollectionDeleted(int collectionId)
+{
+    QTreeWidgetItem *collectionItem = m_collectionItems.take(collectionId);
+    if (!collectionItem) {
+        return;
+    }
+    
+    for (int i = 0; i < collectionItem->childCount(); ++i) {
+        m_requestItems.remove(collectionItem->child(i)->data(0, Qt::UserRole).toInt());
+    }
+    delete collectionItem;
+}
+
+void CollectionManager::onRequestInserted(int requestId, int collectionId, const QString &name,
+                                          const QString &method, const QString &url)
+{
+    QTreeWidgetItem *collectionItem = m_collectionItems.value(collectionId);
+    if (!collectionItem || m_requestItems.contains(requestId)) {
+        return;
+    }
+    
+    QTreeWidgetItem *requestItem = addRequestToTree(collectionItem, requestId, name, method, url);
+    moveToSortedRow(requestItem);
+    collectionItem->setExpanded(true);
+}
+
+void CollectionManager::onRequestUpdated(int requestId, const QString &name, const QString &method, const QString &url)
+{
+    QTreeWidgetItem *requestItem = m_requestItems.value(requestId);
+    if (!requestItem) {
+        return;
+    }
+    
     requestItem->setText(0, QString("%1 %2").arg(method, name));
-    requestItem->setData(0, Qt::UserRole, id);
-    requestItem->setData(0, Qt::UserRole + 1, "request");
     requestItem->setToolTip(0, url);
+    if (requestItem->data(0, Qt::UserRole + 2).toString() != name) {
+        requestItem->setData(0, Qt::UserRole + 2, name);
+        moveToSortedRow(requestItem);
+    }
+}
+
+void CollectionManager::onRequestDeleted(int requestId)
+{
+    delete m_requestItems.take(requestId);
+}
+
+void CollectionManager::onSearchTextChanged(const QString &text)
+{
+    bool searching = !text.trimmed().isEmpty();
+    m_collectionsTree->setVisible(!searching);
+    m_searchResultsTree->setVisible(searching);
+    
+    if (searching) {
+        m_searchTimer->start();
+    } else {
+        // Abandon any search still running
+        m_searchTimer->stop();
+        m_searchWorker->setLatestGeneration(++m_searchGeneration);
+        m_searchResultsTree->clear();
+        m_requestResultsItem = nullptr;
+        m_historyResultsItem = nullptr;
+    }
+}
+
+void CollectionManager::startSearch()
+{
+    m_searchResultsTree->clear();
+    m_requestResultsItem = new QTreeWidgetItem(m_searchResultsTree, QStringList("Requests"));
+    m_historyResultsItem = new QTreeWidgetItem(m_searchResultsTree, QStringList("History"));
+    m_requestResultsItem->setExpanded(true);
+    m_historyResultsItem->setExpanded(true);
+    m_searchResultsTree->setHeaderLabel("Searching...");
+    
+    m_searchWorker->setLatestGeneration(++m_searchGeneration);
+    emit searchRequested(m_searchGeneration, DatabaseManager::instance().getCurrentDatabasePath(),
+                         m_searchEdit->text(), 200);
+}
+
+void CollectionManager::onSearchResults(quint64 generation, const QList<SearchResult> &results)
+{
+    if (generation != m_searchGeneration || !m_requestResultsItem) {
+        return;
+    }
+    
+    for (const SearchResult &result : results) {
+        QTreeWidgetItem *item;
+        if (result.kind == SearchResult::Request) {
+            item = new QTreeWidgetItem(m_requestResultsItem);
+            item->setText(0, QString("%1 %2").arg(result.method, result.name));
+            item->setData(0, Qt::UserRole + 1, "request");
+        } else {
+            item = new QTreeWidgetItem(m_historyResultsItem);
+            item->setText(0, QString("%1 %2  (%3)").arg(result.method, result.url).arg(result.statusCode));
+            item->setData(0, Qt::UserRole + 1, "history");
+        }
+        item->setData(0, Qt::UserRole, result.id);
+        item->setToolTip(0, QString("%1\n%2").arg(result.url, result.snippet));
+    }
+}
+
+void CollectionManager::onSearchFinished(quint64 generation)
+{
+    if (generation != m_searchGeneration || !m_requestResultsItem) {
+        return;
+    }
+    
+    m_requestResultsItem->setText(0, QString("Requests (%1)").arg(m_requestResultsItem->childCount()));
+    m_historyResultsItem->setText(0, QString("History (%1)").arg(m_historyResultsItem->childCount()));
+    m_searchResultsTree->setHeaderLabel("Search Results");
 }
 
 void CollectionManager::createNewCollection()
@@ -122,9 +366,8 @@ void CollectionManager::createNewCollection()
                                               "Collection description (optional):", 
                                               QLineEdit::Normal, "", &ok);
     
-    if (DatabaseManager::instance().createCollection(name, description)) {
-        loadCollections(); // Reload to show the new collection
-    } else {
+    // The tree picks up the new collection from DatabaseManager::collectionInserted
+    if (!DatabaseManager::instance().createCollection(name, description)) {
         QMessageBox::warning(this, "Error", "Failed to create collection.");
     }
 }
@@ -159,8 +402,8 @@ void CollectionManager::createNewRequest()
     
     // Create a basic GET request
     if (DatabaseManager::instance().saveRequest(collectionId, name, "GET", 
-                                              "https://api.example.com", "", "", "")) {
-        loadCollections(); // Reload to show the new request
+                                              "https://api.example.com", HttpHeaders(), "", "")) {
+        collectionItem->setExpanded(true);
     } else {
         QMessageBox::warning(this, "Error", "Failed to create request.");
     }
@@ -191,9 +434,8 @@ void CollectionManager::deleteSelected()
         success = DatabaseManager::instance().deleteRequest(id);
     }
     
-    if (success) {
-        loadCollections(); // Reload to reflect changes
-    } else {
+    // On success the item has already been removed by the change notification
+    if (!success) {
         QMessageBox::warning(this, "Error", QString("Failed to delete %1.").arg(itemType));
     }
 }
@@ -202,7 +444,26 @@ void CollectionManager::onItemDoubleClicked(QTreeWidgetItem *item, int column)
 {
     Q_UNUSED(column)
     
-    if (!item || item->data(0, Qt::UserRole + 1).toString() != "request") {
+    if (!item) {
+        return;
+    }
+    
+    // History entries from search results open as an unsaved request
+    if (item->data(0, Qt::UserRole + 1).toString() == "history") {
+        QSqlQuery query(DatabaseManager::instance().database());
+        query.prepare("SELECT method, url, headers, body FROM history WHERE id = ?");
+        query.addBindValue(item->data(0, Qt::UserRole).toInt());
+        
+        if (query.exec() && query.next()) {
+            QString method = query.value(0).toString();
+            QString url = query.value(1).toString();
+            HttpHeaders headers = HttpHeaders::fromStored(query.value(2).toString());
+            emit requestSelected(url, method, url, headers, query.value(3).toString(), QString());
+        }
+        return;
+    }
+    
+    if (item->data(0, Qt::UserRole + 1).toString() != "request") {
         return;
     }
     
@@ -217,7 +478,7 @@ void CollectionManager::onItemDoubleClicked(QTreeWidgetItem *item, int column)
         QString name = query.value(0).toString();
         QString method = query.value(1).toString();
         QString url = query.value(2).toString();
-        QString headers = query.value(3).toString();
+        HttpHeaders headers = HttpHeaders::fromStored(query.value(3).toString());
         QString body = query.value(4).toString();
         QString parameters = query.value(5).toString();
         
@@ -5,6 +5,11 @@
 #include <QtWidgets/QTreeWidget>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QLineEdit>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QThread>
+#include "SearchWorker.h"
+#include "HttpHeaders.h"
 
 class CollectionManager : public QWidget
 {
@@ -12,10 +17,12 @@ class CollectionManager : public QWidget
     
 public:
     explicit CollectionManager(QWidget *parent = nullptr);
+    ~CollectionManager();
     
 signals:
     void requestSelected(const QString &name, const QString &method, const QString &url,
-                        const QString &headers, const QString &body, const QString &parameters);
+                        const HttpHeaders &headers, const QString &body, const QString &parameters);
+    void searchRequested(quint64 generation, const QString &databasePath, const QString &text, int limit);
     
 private slots:
     void createNewCollection();
@@ -23,18 +30,48 @@ private slots:
     void deleteSelected();
     void onItemDoubleClicked(QTreeWidgetItem *item, int column);
     
+    // Patch the tree in place from DatabaseManager change notifications
+    void onCollectionInserted(int collectionId, const QString &name, const QString &description);
+    void onCollectionUpdated(int collectionId, const QString &name, const QString &description);
+    void onCollectionDeleted(int collectionId);
+    void onRequestInserted(int requestId, int collectionId, const QString &name,
+                           const QString &method, const QString &url);
+    void onRequestUpdated(int requestId, const QString &name, const QString &method, const QString &url);
+    void onRequestDeleted(int requestId);
+    
+    // As-you-type search, run by m_searchWorker on m_searchThread
+    void onSearchTextChanged(const QString &text);
+    void startSearch();
+    void onSearchResults(quint64 generation, const QList<SearchResult> &results);
+    void onSearchFinished(quint64 generation);
+    
 private:
     void setupUI();
     void loadCollections();
-    void addCollectionToTree(int id, const QString &name, const QString &description);
-    void addRequestToTree(QTreeWidgetItem *parent, int id, const QString &name, 
-                         const QString &method, const QString &url);
+    QTreeWidgetItem *addCollectionToTree(int id, const QString &name, const QString &description);
+    QTreeWidgetItem *addRequestToTree(QTreeWidgetItem *parent, int id, const QString &name, 
+                                      const QString &method, const QString &url);
+    // Row at which an item called name keeps parent's children (or the top
+    // level when parent is null) ordered by name
+    int sortedRow(QTreeWidgetItem *parent, const QString &name) const;
+    void moveToSortedRow(QTreeWidgetItem *item);
     
     QTreeWidget *m_collectionsTree;
     QPushButton *m_newCollectionButton;
     QPushButton *m_newRequestButton;
     QPushButton *m_deleteButton;
     QLineEdit *m_searchEdit;
+    
+    QHash<int, QTreeWidgetItem*> m_collectionItems;
+    QHash<int, QTreeWidgetItem*> m_requestItems;
+    
+    QTreeWidget *m_searchResultsTree;
+    QTreeWidgetItem *m_requestResultsItem;
+    QTreeWidgetItem *m_historyResultsItem;
+    QTimer *m_searchTimer;
+    QThread *m_searchThread;
+    SearchWorker *m_searchWorker;
+    quint64 m_searchGeneration;
 };
 
 #endif // COLLECTIONMANAGER_H
\ No newline at end of file
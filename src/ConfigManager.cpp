@@ -1,4 +1,5 @@
 #include "ConfigManager.h"
+#include "ResponseBuffer.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 
@@ -48,6 +49,46 @@ ConfigManager::ConfigManager(QObject *parent)
     if (!m_settings->contains("Database/NetworkEnabled")) {
         m_settings->setValue("Database/NetworkEnabled", false);
     }
+    
+    if (!m_settings->contains("Http/MaxConcurrentPerHost")) {
+        m_settings->setValue("Http/MaxConcurrentPerHost", 6);
+    }
+    
+    if (!m_settings->contains("Http/MaxInMemoryResponseBytes")) {
+        m_settings->setValue("Http/MaxInMemoryResponseBytes", ResponseBuffer::DefaultMaxInMemorySize);
+    }
+    
+    if (!m_settings->contains("Http/Http2Allowed")) {
+        m_settings->setValue("Http/Http2Allowed", true);
+    }
+    
+    if (!m_settings->contains("Http/ConnectionIdleTimeoutSeconds")) {
+        m_settings->setValue("Http/ConnectionIdleTimeoutSeconds", 30);
+    }
+    
+    if (!m_settings->contains("Tests/Concurrency")) {
+        m_settings->setValue("Tests/Concurrency", 1);
+    }
+    
+    if (!m_settings->contains("Tests/TimeoutSeconds")) {
+        m_settings->setValue("Tests/TimeoutSeconds", 30);
+    }
+    
+    if (!m_settings->contains("Tests/SuiteTimeoutSeconds")) {
+        m_settings->setValue("Tests/SuiteTimeoutSeconds", 0);
+    }
+    
+    if (!m_settings->contains("History/BatchSize")) {
+        m_settings->setValue("History/BatchSize", 64);
+    }
+    
+    if (!m_settings->contains("History/FlushIntervalMs")) {
+        m_settings->setValue("History/FlushIntervalMs", 1000);
+    }
+    
+    if (!m_settings->contains("History/CompactionIntervalMinutes")) {
+        m_settings->setValue("History/CompactionIntervalMinutes", 10);
+    }
 }
 
 QString ConfigManager::getDatabasePath() const
@@ -140,6 +181,197 @@ void ConfigManager::setNetworkPort(int port)
     m_settings->setValue("Network/Port", port);
 }
 
+int ConfigManager::getMaxConcurrentRequestsPerHost() const
+{
+    return m_settings->value("Http/MaxConcurrentPerHost", 6).toInt();
+}
+
+void ConfigManager::setMaxConcurrentRequestsPerHost(int maxRequests)
+{
+    m_settings->setValue("Http/MaxConcurrentPerHost", maxRequests);
+}
+
+qint64 ConfigManager::getMaxInMemoryResponseSize() const
+{
+    return m_settings->value("Http/MaxInMemoryResponseBytes", ResponseBuffer::DefaultMaxInMemorySize).toLongLong();
+}
+
+void ConfigManager::setMaxInMemoryResponseSize(qint64 maxBytes)
+{
+    m_settings->setValue("Http/MaxInMemoryResponseBytes", maxBytes);
+}
+
+bool ConfigManager::isHttp2Allowed() const
+{
+    return m_settings->value("Http/Http2Allowed", true).toBool();
+}
+
+void ConfigManager::setHttp2Allowed(bool allowed)
+{
+    m_settings->setValue("Http/Http2Allowed", allowed);
+}
+
+int ConfigManager::getConnectionIdleTimeout() const
+{
+    return m_settings->value("Http/ConnectionIdleTimeoutSeconds", 30).toInt();
+}
+
+void ConfigManager::setConnectionIdleTimeout(int seconds)
+{
+    m_settings->setValue("Http/ConnectionIdleTimeoutSeconds", seconds);
+}
+
+RetryPolicy ConfigManager::getRetryPolicy() const
+{
+    RetryPolicy defaults;
+    RetryPolicy policy;
+    policy.maxAttempts = qMax(1, m_settings->value("Retry/MaxAttempts", defaults.maxAttempts).toInt());
+    policy.retryNetworkErrors = m_settings->value("Retry/NetworkErrors", defaults.retryNetworkErrors).toBool();
+    policy.retryNonIdempotent = m_settings->value("Retry/NonIdempotent", defaults.retryNonIdempotent).toBool();
+    policy.initialBackoffMs = m_settings->value("Retry/InitialBackoffMs", defaults.initialBackoffMs).toInt();
+    policy.multiplier = m_settings->value("Retry/Multiplier", defaults.multiplier).toDouble();
+    policy.maxBackoffMs = m_settings->value("Retry/MaxBackoffMs", defaults.maxBackoffMs).toInt();
+    policy.jitter = m_settings->value("Retry/Jitter", defaults.jitter).toDouble();
+    policy.respectRetryAfter = m_settings->value("Retry/RespectRetryAfter", defaults.respectRetryAfter).toBool();
+    policy.maxRetryAfterMs = m_settings->value("Retry/MaxRetryAfterMs", defaults.maxRetryAfterMs).toInt();
+    
+    // Comma-separated in the settings file
+    if (m_settings->contains("Retry/StatusCodes")) {
+        policy.retryStatusCodes.clear();
+        const QStringList codes = m_settings->value("Retry/StatusCodes").toStringList();
+        for (const QString &code : codes) {
+            bool ok = false;
+            int statusCode = code.trimmed().toInt(&ok);
+            if (ok) {
+                policy.retryStatusCodes.insert(statusCode);
+            }
+        }
+    }
+    return policy;
+}
+
+void ConfigManager::setRetryPolicy(const RetryPolicy &policy)
+{
+    QStringList codes;
+    for (int code : policy.retryStatusCodes) {
+        codes << QString::number(code);
+    }
+    codes.sort();
+    
+    m_settings->setValue("Retry/MaxAttempts", policy.maxAttempts);
+    m_settings->setValue("Retry/StatusCodes", codes);
+    m_settings->setValue("Retry/NetworkErrors", policy.retryNetworkErrors);
+    m_settings->setValue("Retry/NonIdempotent", policy.retryNonIdempotent);
+    m_settings->setValue("Retry/InitialBackoffMs", policy.initialBackoffMs);
+    m_settings->setValue("Retry/Multiplier", policy.multiplier);
+    m_settings->setValue("Retry/MaxBackoffMs", policy.maxBackoffMs);
+    m_settings->setValue("Retry/Jitter", policy.jitter);
+    m_settings->setValue("Retry/RespectRetryAfter", policy.respectRetryAfter);
+    m_settings->setValue("Retry/MaxRetryAfterMs", policy.maxRetryAfterMs);
+}
+
+int ConfigManager::getTestConcurrency() const
+{
+    return m_settings->value("Tests/Concurrency", 1).toInt();
+}
+
+void ConfigManager::setTestConcurrency(int concurrency)
+{
+    m_settings->setValue("Tests/Concurrency", concurrency);
+}
+
+int ConfigManager::getTestTimeout() const
+{
+    return m_settings->value("Tests/TimeoutSeconds", 30).toInt();
+}
+
+void ConfigManager::setTestTimeout(int seconds)
+{
+    m_settings->setValue("Tests/TimeoutSeconds", seconds);
+}
+
+int ConfigManager::getSuiteTimeout() const
+{
+    return m_settings->value("Tests/SuiteTimeoutSeconds", 0).toInt();
+}
+
+void ConfigManager::setSuiteTimeout(int seconds)
+{
+    m_settings->setValue("Tests/SuiteTimeoutSeconds", seconds);
+}
+
+StorageProfile ConfigManager::getStorageProfile() const
+{
+    StorageProfile defaults;
+    StorageProfile profile;
+    profile.journalMode = m_settings->value("Storage/JournalMode", defaults.journalMode).toString();
+    profile.synchronous = m_settings->value("Storage/Synchronous", defaults.synchronous).toString();
+    profile.cacheSizeKiB = m_settings->value("Storage/CacheSizeKiB", defaults.cacheSizeKiB).toInt();
+    profile.mmapSize = m_settings->value("Storage/MmapSize", defaults.mmapSize).toLongLong();
+    profile.tempStore = m_settings->value("Storage/TempStore", defaults.tempStore).toString();
+    profile.busyTimeoutMs = m_settings->value("Storage/BusyTimeoutMs", defaults.busyTimeoutMs).toInt();
+    return profile;
+}
+
+void ConfigManager::setStorageProfile(const StorageProfile &profile)
+{
+    m_settings->setValue("Storage/JournalMode", profile.journalMode);
+    m_settings->setValue("Storage/Synchronous", profile.synchronous);
+    m_settings->setValue("Storage/CacheSizeKiB", profile.cacheSizeKiB);
+    m_settings->setValue("Storage/MmapSize", profile.mmapSize);
+    m_settings->setValue("Storage/TempStore", profile.tempStore);
+    m_settings->setValue("Storage/BusyTimeoutMs", profile.busyTimeoutMs);
+}
+
+int ConfigManager::getHistoryBatchSize() const
+{
+    return m_settings->value("History/BatchSize", 64).toInt();
+}
+
+void ConfigManager::setHistoryBatchSize(int entries)
+{
+    m_settings->setValue("History/BatchSize", entries);
+}
+
+int ConfigManager::getHistoryFlushInterval() const
+{
+    return m_settings->value("History/FlushIntervalMs", 1000).toInt();
+}
+
+void ConfigManager::setHistoryFlushInterval(int milliseconds)
+{
+    m_settings->setValue("History/FlushIntervalMs", milliseconds);
+}
+
+RetentionPolicy ConfigManager::getRetentionPolicy() const
+{
+    RetentionPolicy defaults;
+    RetentionPolicy policy;
+    policy.maxEntries = m_settings->value("History/MaxEntries", defaults.maxEntries).toLongLong();
+    policy.maxAgeDays = m_settings->value("History/MaxAgeDays", defaults.maxAgeDays).toInt();
+    policy.maxTotalBytes = m_settings->value("History/MaxTotalBytes", defaults.maxTotalBytes).toLongLong();
+    policy.keepPerUrl = m_settings->value("History/KeepPerUrl", defaults.keepPerUrl).toInt();
+    return policy;
+}
+
+void ConfigManager::setRetentionPolicy(const RetentionPolicy &policy)
+{
+    m_settings->setValue("History/MaxEntries", policy.maxEntries);
+    m_settings->setValue("History/MaxAgeDays", policy.maxAgeDays);
+    m_settings->setValue("History/MaxTotalBytes", policy.maxTotalBytes);
+    m_settings->setValue("History/KeepPerUrl", policy.keepPerUrl);
+}
+
+int ConfigManager::getCompactionInterval() const
+{
+    return m_settings->value("History/CompactionIntervalMinutes", 10).toInt();
+}
+
+void ConfigManager::setCompactionInterval(int minutes)
+{
+    m_settings->setValue("History/CompactionIntervalMinutes", minutes);
+}
+
 void ConfigManager::sync()
 {
     m_settings->sync();
@@ -4,6 +4,9 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QSettings>
+#include "StorageProfile.h"
+#include "RetryPolicy.h"
+#include "HistoryCompactor.h"
 
 class ConfigManager : public QObject
 {
@@ -40,6 +43,42 @@ public:
     int getNetworkPort() const;
     void setNetworkPort(int port);
     
+    // HTTP client settings
+    int getMaxConcurrentRequestsPerHost() const;
+    void setMaxConcurrentRequestsPerHost(int maxRequests);
+    qint64 getMaxInMemoryResponseSize() const;
+    void setMaxInMemoryResponseSize(qint64 maxBytes);
+    bool isHttp2Allowed() const;
+    void setHttp2Allowed(bool allowed);
+    int getConnectionIdleTimeout() const;
+    void setConnectionIdleTimeout(int seconds);
+    // Used by request tabs and test runs; disabled by default
+    RetryPolicy getRetryPolicy() const;
+    void setRetryPolicy(const RetryPolicy &policy);
+    
+    // Test runner settings
+    int getTestConcurrency() const;
+    void setTestConcurrency(int concurrency);
+    // Seconds; 0 disables the deadline
+    int getTestTimeout() const;
+    void setTestTimeout(int seconds);
+    int getSuiteTimeout() const;
+    void setSuiteTimeout(int seconds);
+    
+    // Storage settings
+    StorageProfile getStorageProfile() const;
+    void setStorageProfile(const StorageProfile &profile);
+    
+    // History settings
+    int getHistoryBatchSize() const;
+    void setHistoryBatchSize(int entries);
+    int getHistoryFlushInterval() const;
+    void setHistoryFlushInterval(int milliseconds);
+    RetentionPolicy getRetentionPolicy() const;
+    void setRetentionPolicy(const RetentionPolicy &policy);
+    int getCompactionInterval() const;
+    void setCompactionInterval(int minutes);
+    
     // Sync settings
     void sync();
 
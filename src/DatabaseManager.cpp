@@ -1,4 +1,5 @@
 #include "DatabaseManager.h"
+#include "ConfigManager.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QDebug>
@@ -14,7 +15,17 @@ DatabaseManager& DatabaseManager::instance()
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
+    , m_historyWriter(new HistoryWriter(this))
+    , m_historyCompactor(new HistoryCompactor(this))
+    , m_upgrader(new DatabaseUpgrader(this))
+    , m_fullTextSearchAvailable(false)
 {
+    connect(m_historyCompactor, &HistoryCompactor::storageStatsChanged,
+            this, &DatabaseManager::responseStorageStatsChanged);
+    // Direct, so the writer holds its batches before the VACUUM takes the lock
+    connect(m_historyCompactor, &HistoryCompactor::maintenanceChanged,
+            m_historyWriter, &HistoryWriter::setMaintenanceRunning, Qt::DirectConnection);
+    connect(m_upgrader, &DatabaseUpgrader::taskFinished, this, &DatabaseManager::onUpgradeFinished);
 }
 
 bool DatabaseManager::initialize()
@@ -36,6 +47,11 @@ bool DatabaseManager::initialize(const QString &customPath)
     // Create database directory if it doesn't exist
     QDir().mkpath(customPath);
     
+    // Finish writing history to the previous database before switching
+    m_historyWriter->drain();
+    m_historyCompactor->stop();
+    m_upgrader->stop();
+    
     m_currentDatabasePath = customPath + "/apitester.db";
     
     // Initialize SQLite database
@@ -47,7 +63,34 @@ bool DatabaseManager::initialize(const QString &customPath)
         return false;
     }
     
-    return createTables();
+    // Only takes effect on a new, empty file; the history compactor switches
+    // existing files over on its own thread
+    QSqlQuery autoVacuum(m_database);
+    autoVacuum.exec("PRAGMA auto_vacuum = INCREMENTAL");
+    
+    // WAL lets history browsing read while the history writer commits
+    StorageProfile profile = ConfigManager::instance()->getStorageProfile();
+    if (!profile.apply(m_database)) {
+        qWarning() << "Continuing with SQLite default storage settings";
+    }
+    
+    if (!createTables()) {
+        return false;
+    }
+    
+    // History is written on a background thread so responses never wait on disk
+    m_historyWriter->setBatchSize(ConfigManager::instance()->getHistoryBatchSize());
+    m_historyWriter->setFlushInterval(ConfigManager::instance()->getHistoryFlushInterval());
+    m_historyWriter->start(m_currentDatabasePath, profile);
+    
+    m_historyCompactor->setPolicy(ConfigManager::instance()->getRetentionPolicy());
+    m_historyCompactor->setInterval(ConfigManager::instance()->getCompactionInterval());
+    m_historyCompactor->start(m_currentDatabasePath, profile);
+    
+    // Finishes schema upgrades too large to run before the window shows
+    m_upgrader->start(m_currentDatabasePath, profile);
+    
+    return true;
 }
 
 bool DatabaseManager::createTables()
@@ -99,6 +142,7 @@ bool DatabaseManager::createTables()
             response TEXT,
             status_code INTEGER,
             response_time INTEGER,
+            timing TEXT,
             created_at DATETIME DEFAULT CURRENT_TIMESTAMP
         )
     )")) {
@@ -106,6 +150,63 @@ bool DatabaseManager::createTables()
         return false;
     }
     
+    // Columns added after the first release
+    if (!ensureColumn("history", "timing", "TEXT")) {
+        return false;
+    }
+    if (!ensureColumn("history", "response_blob_id", "INTEGER REFERENCES response_blobs (id)")) {
+        return false;
+    }
+    // Set when only the preview of a body spilled to disk was kept
+    if (!ensureColumn("history", "response_size", "INTEGER")
+        || !ensureColumn("history", "response_truncated", "INTEGER NOT NULL DEFAULT 0")) {
+        return false;
+    }
+    
+    // Deduplicated, compressed response bodies
+    if (!ResponseBlobStore::createTables(m_database)) {
+        return false;
+    }
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_history_response_blob ON history (response_blob_id)")) {
+        qWarning() << "Failed to create history blob index:" << query.lastError().text();
+        return false;
+    }
+    // Upgrades that finish in the background
+    if (!DatabaseUpgrader::createTable(m_database)) {
+        return false;
+    }
+    if (!migrateResponseStorage()) {
+        return false;
+    }
+    if (!enableIncrementalVacuum()) {
+        return false;
+    }
+    if (!migrateHeaderStorage()) {
+        return false;
+    }
+    
+    // Lets the compactor find the oldest entries of each URL
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_history_url ON history (url, id)")) {
+        qWarning() << "Failed to create history url index:" << query.lastError().text();
+        return false;
+    }
+    
+    // Loading the collection tree joins requests on collection_id and
+    // orders by name within each collection
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_requests_collection ON requests (collection_id, name)")) {
+        qWarning() << "Failed to create requests index:" << query.lastError().text();
+        return false;
+    }
+    
+    // Full-text indexes for search; kept current by triggers
+    m_pendingFullTextIndexes.clear();
+    bool fullTextIndexed = ensureFullTextIndex("requests", QStringList() << "name" << "url" << "headers" << "body")
+                           && ensureFullTextIndex("history", QStringList() << "url");
+    if (!fullTextIndexed) {
+        qWarning() << "Full-text search is unavailable; SQLite was built without FTS5";
+    }
+    setFullTextSearchAvailable(fullTextIndexed && m_pendingFullTextIndexes.isEmpty());
+    
     // Create default collection if none exists
     query.prepare("SELECT COUNT(*) FROM collections");
     if (query.exec() && query.next()) {
@@ -117,6 +218,262 @@ bool DatabaseManager::createTables()
     return true;
 }
 
+bool DatabaseManager::ensureColumn(const QString &table, const QString &column, const QString &definition)
+{
+    QSqlQuery query(m_database);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        qWarning() << "Failed to inspect table" << table << ":" << query.lastError().text();
+        return false;
+    }
+    
+    while (query.next()) {
+        if (query.value(1).toString() == column) {
+            return true;
+        }
+    }
+    
+    if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, definition))) {
+        qWarning() << "Failed to add column" << column << "to" << table << ":" << query.lastError().text();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::migrateResponseStorage()
+{
+    // Schema version 1 moved history responses out of the history table
+    QSqlQuery query(m_database);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qWarning() << "Failed to read schema version:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() >= 1) {
+        return true;
+    }
+    query.finish();
+    
+    // The history index used to cover response text; bodies are now indexed
+    // once per blob, so it is rebuilt over urls only
+    const QStringList dropStatements = {
+        "DROP TRIGGER IF EXISTS history_fts_ai",
+        "DROP TRIGGER IF EXISTS history_fts_ad",
+        "DROP TRIGGER IF EXISTS history_fts_au",
+        "DROP TABLE IF EXISTS history_fts"
+    };
+    for (const QString &statement : dropStatements) {
+        if (!query.exec(statement)) {
+            qWarning() << "Failed to drop old history index:" << query.lastError().text();
+            return false;
+        }
+    }
+    
+    // Moving the bodies rewrites every history row, so the upgrader does it
+    // in the background; until then loadHistoryResponse() reads the inline
+    // response column of the rows it has not reached yet
+    if (!DatabaseUpgrader::addTask(m_database, DatabaseUpgrader::HistoryBodies)) {
+        return false;
+    }
+    
+    if (!query.exec("PRAGMA user_version = 1")) {
+        qWarning() << "Failed to update schema version:" << query.lastError().text();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::enableIncrementalVacuum()
+{
+    // Schema version 2 switched the file to incremental auto-vacuum so the
+    // history compactor can give freed pages back to the file system
+    QSqlQuery query(m_database);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qWarning() << "Failed to read schema version:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() >= 2) {
+        return true;
+    }
+    query.finish();
+    
+    // Changing auto_vacuum on an existing file only takes effect after a
+    // full VACUUM. That rewrites the whole file, so it is left to the history
+    // compactor's thread rather than run here while the UI waits.
+    if (!query.exec("PRAGMA user_version = 2")) {
+        qWarning() << "Failed to update schema version:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::migrateHeaderStorage()
+{
+    // Schema version 3 stores headers as a JSON array of [name, value] pairs
+    // instead of "Name: value" lines
+    QSqlQuery query(m_database);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qWarning() << "Failed to read schema version:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() >= 3) {
+        return true;
+    }
+    query.finish();
+    
+    // Saved requests are few enough to convert now; history is converted by
+    // the upgrader, and HttpHeaders::fromStored() reads either format meanwhile
+    if (!convertStoredHeaders("requests")
+        || !DatabaseUpgrader::addTask(m_database, DatabaseUpgrader::HistoryHeaders)) {
+        return false;
+    }
+    
+    if (!query.exec("PRAGMA user_version = 3")) {
+        qWarning() << "Failed to update schema version:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::convertStoredHeaders(const QString &table)
+{
+    // Converted in chunks, one transaction each; rows already holding JSON
+    // are skipped, so an interrupted migration resumes where it stopped
+    const int chunkSize = 500;
+    qint64 lastId = 0;
+    QSqlQuery select(m_database);
+    QSqlQuery update(m_database);
+    select.prepare(QString("SELECT id, headers FROM %1 WHERE id > ? AND headers <> '' "
+                           "AND headers NOT LIKE '[%' ORDER BY id LIMIT ?").arg(table));
+    update.prepare(QString("UPDATE %1 SET headers = ? WHERE id = ?").arg(table));
+    
+    forever {
+        select.addBindValue(lastId);
+        select.addBindValue(chunkSize);
+        if (!select.exec()) {
+            qWarning() << "Failed to read" << table << "headers for migration:" << select.lastError().text();
+            return false;
+        }
+        
+        QVector<QPair<qint64, QString>> rows;
+        while (select.next()) {
+            rows.append(qMakePair(select.value(0).toLongLong(), select.value(1).toString()));
+        }
+        select.finish();
+        if (rows.isEmpty()) {
+            break;
+        }
+        
+        m_database.transaction();
+        for (const auto &row : rows) {
+            update.addBindValue(HttpHeaders::fromText(row.second).toJson());
+            update.addBindValue(row.first);
+            if (!update.exec()) {
+                qWarning() << "Failed to migrate" << table << "headers" << row.first << ":" << update.lastError().text();
+                m_database.rollback();
+                return false;
+            }
+        }
+        if (!m_database.commit()) {
+            qWarning() << "Failed to commit header migration:" << m_database.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+        
+        lastId = rows.last().first;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::ensureFullTextIndex(const QString &table, const QStringList &columns)
+{
+    // External-content FTS5 table: the index stores no second copy of the text
+    const QString ftsTable = table + "_fts";
+    QSqlQuery query(m_database);
+    
+    query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = ?");
+    query.addBindValue(ftsTable);
+    bool exists = query.exec() && query.next() && query.value(0).toInt() > 0;
+    
+    if (!exists && !query.exec(QString("CREATE VIRTUAL TABLE %1 USING fts5(%2, content='%3', content_rowid='id')")
+                                   .arg(ftsTable, columns.join(", "), table))) {
+        qWarning() << "Failed to create full-text index" << ftsTable << ":" << query.lastError().text();
+        return false;
+    }
+    
+    QStringList newValues;
+    QStringList oldValues;
+    for (const QString &column : columns) {
+        newValues << "new." + column;
+        oldValues << "old." + column;
+    }
+    const QString columnList = columns.join(", ");
+    const QString insertNew = QString("INSERT INTO %1(rowid, %2) VALUES (new.id, %3);")
+                                  .arg(ftsTable, columnList, newValues.join(", "));
+    const QString deleteOld = QString("INSERT INTO %1(%1, rowid, %2) VALUES ('delete', old.id, %3);")
+                                  .arg(ftsTable, columnList, oldValues.join(", "));
+    
+    // Rows between the upgrader's position and target are indexed by the
+    // upgrader; the triggers leave them alone until it gets there
+    const QString pendingRow = QString("EXISTS (SELECT 1 FROM pending_upgrades WHERE name = '%1' "
+                                       "AND %2.id > position AND %2.id <= target)").arg(ftsTable);
+    const QString unlessNewPending = "WHEN NOT " + pendingRow.arg("new");
+    const QString unlessOldPending = "WHEN NOT " + pendingRow.arg("old");
+    
+    const QStringList triggers = {
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ai AFTER INSERT ON %2 %3 BEGIN %4 END")
+            .arg(ftsTable, table, unlessNewPending, insertNew),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ad AFTER DELETE ON %2 %3 BEGIN %4 END")
+            .arg(ftsTable, table, unlessOldPending, deleteOld),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_au AFTER UPDATE OF %2 ON %3 %4 BEGIN %5 %6 END")
+            .arg(ftsTable, columnList, table, unlessOldPending, deleteOld, insertNew)
+    };
+    for (const QString &trigger : triggers) {
+        if (!query.exec(trigger)) {
+            qWarning() << "Failed to create full-text trigger on" << table << ":" << query.lastError().text();
+            return false;
+        }
+    }
+    
+    // Rows written before the index existed are indexed in the background
+    if (!exists) {
+        qint64 lastId = 0;
+        if (query.exec(QString("SELECT MAX(id) FROM %1").arg(table)) && query.next()) {
+            lastId = query.value(0).toLongLong();
+        }
+        query.finish();
+        if (lastId > 0 && !DatabaseUpgrader::addTask(m_database, ftsTable, lastId, columnList)) {
+            return false;
+        }
+    }
+    if (DatabaseUpgrader::isPending(m_database, ftsTable)) {
+        m_pendingFullTextIndexes << ftsTable;
+    }
+    
+    return true;
+}
+
+void DatabaseManager::setFullTextSearchAvailable(bool available)
+{
+    if (m_fullTextSearchAvailable == available) {
+        return;
+    }
+    m_fullTextSearchAvailable = available;
+    emit fullTextSearchAvailableChanged(available);
+}
+
+void DatabaseManager::onUpgradeFinished(const QString &name)
+{
+    // A late signal from before a database switch must not enable search
+    if (DatabaseUpgrader::isPending(m_database, name)) {
+        return;
+    }
+    if (m_pendingFullTextIndexes.removeAll(name) > 0 && m_pendingFullTextIndexes.isEmpty()) {
+        setFullTextSearchAvailable(true);
+    }
+}
+
 bool DatabaseManager::createCollection(const QString &name, const QString &description)
 {
     QSqlQuery query(m_database);
@@ -129,6 +486,8 @@ bool DatabaseManager::createCollection(const QString &name, const QString &descr
         return false;
     }
     
+    emit collectionInserted(query.lastInsertId().toInt(), name, description);
+    
     return true;
 }
 
@@ -143,6 +502,8 @@ bool DatabaseManager::deleteCollection(int collectionId)
         return false;
     }
     
+    emit collectionDeleted(collectionId);
+    
     return true;
 }
 
@@ -159,11 +520,13 @@ bool DatabaseManager::updateCollection(int collectionId, const QString &name, co
         return false;
     }
     
+    emit collectionUpdated(collectionId, name, description);
+    
     return true;
 }
 
 bool DatabaseManager::saveRequest(int collectionId, const QString &name, const QString &method,
-                                const QString &url, const QString &headers, const QString &body,
+                                const QString &url, const HttpHeaders &headers, const QString &body,
                                 const QString &parameters)
 {
     QSqlQuery query(m_database);
@@ -172,7 +535,7 @@ bool DatabaseManager::saveRequest(int collectionId, const QString &name, const Q
     query.addBindValue(name);
     query.addBindValue(method);
     query.addBindValue(url);
-    query.addBindValue(headers);
+    query.addBindValue(headers.toJson());
     query.addBindValue(body);
     query.addBindValue(parameters);
     
@@ -181,6 +544,8 @@ bool DatabaseManager::saveRequest(int collectionId, const QString &name, const Q
         return false;
     }
     
+    emit requestInserted(query.lastInsertId().toInt(), collectionId, name, method, url);
+    
     return true;
 }
 
@@ -195,11 +560,13 @@ bool DatabaseManager::deleteRequest(int requestId)
         return false;
     }
     
+    emit requestDeleted(requestId);
+    
     return true;
 }
 
 bool DatabaseManager::updateRequest(int requestId, const QString &name, const QString &method,
-                                  const QString &url, const QString &headers, const QString &body,
+                                  const QString &url, const HttpHeaders &headers, const QString &body,
                                   const QString &parameters)
 {
     QSqlQuery query(m_database);
@@ -207,7 +574,7 @@ bool DatabaseManager::updateRequest(int requestId, const QString &name, const QS
     query.addBindValue(name);
     query.addBindValue(method);
     query.addBindValue(url);
-    query.addBindValue(headers);
+    query.addBindValue(headers.toJson());
     query.addBindValue(body);
     query.addBindValue(parameters);
     query.addBindValue(requestId);
@@ -217,38 +584,91 @@ bool DatabaseManager::updateRequest(int requestId, const QString &name, const QS
         return false;
     }
     
+    emit requestUpdated(requestId, name, method, url);
+    
     return true;
 }
 
-bool DatabaseManager::saveToHistory(const QString &method, const QString &url, const QString &headers,
-                                   const QString &body, const QString &response, int statusCode,
-                                   qint64 responseTime)
+bool DatabaseManager::saveToHistory(const QString &method, const QString &url, const HttpHeaders &headers,
+                                   const QString &body, const QByteArray &response, int statusCode,
+                                   qint64 responseTime, const QString &timing, qint64 responseSize)
 {
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO history (method, url, headers, body, response, status_code, response_time) VALUES (?, ?, ?, ?, ?, ?, ?)");
-    query.addBindValue(method);
-    query.addBindValue(url);
-    query.addBindValue(headers);
-    query.addBindValue(body);
-    query.addBindValue(response);
-    query.addBindValue(statusCode);
-    query.addBindValue(responseTime);
+    HistoryEntry entry;
+    entry.method = method;
+    entry.url = url;
+    entry.headers = headers.toJson();
+    entry.body = body;
+    entry.response = response;
+    entry.responseSize = responseSize < 0 ? response.size() : responseSize;
+    entry.responseTruncated = entry.responseSize > response.size();
+    entry.statusCode = statusCode;
+    entry.responseTime = responseTime;
+    entry.timing = timing;
     
-    if (!query.exec()) {
-        qWarning() << "Failed to save to history:" << query.lastError().text();
-        return false;
+    if (m_historyWriter->isRunning()) {
+        m_historyWriter->enqueue(entry);
+        return true;
     }
     
-    return true;
+    // No writer thread (database not initialized yet or already shut down)
+    return HistoryWriter::writeEntries(m_database, QVector<HistoryEntry>() << entry);
+}
+
+QByteArray DatabaseManager::loadHistoryResponse(int historyId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT response_blob_id, response FROM history WHERE id = ?");
+    query.addBindValue(historyId);
+    if (!query.exec() || !query.next()) {
+        return QByteArray();
+    }
+    
+    // Rows written before the migration finished may still hold the body inline
+    if (query.isNull(0)) {
+        return query.value(1).toString().toUtf8();
+    }
+    return ResponseBlobStore::load(m_database, query.value(0).toLongLong());
+}
+
+bool DatabaseManager::flushHistory(int timeoutMs)
+{
+    if (!m_historyWriter->isRunning()) {
+        return true;
+    }
+    return m_historyWriter->waitForFlushed(timeoutMs);
+}
+
+bool DatabaseManager::drainHistory(int timeoutMs)
+{
+    m_historyCompactor->stop();
+    m_upgrader->stop();
+    return m_historyWriter->drain(timeoutMs);
+}
+
+void DatabaseManager::setRetentionPolicy(const RetentionPolicy &policy)
+{
+    ConfigManager::instance()->setRetentionPolicy(policy);
+    m_historyCompactor->setPolicy(policy);
+    m_historyCompactor->requestCompaction();
 }
 
 bool DatabaseManager::clearHistory()
 {
+    // Queued entries would otherwise land after the delete
+    flushHistory();
+    
     QSqlQuery query(m_database);
     if (!query.exec("DELETE FROM history")) {
         qWarning() << "Failed to clear history:" << query.lastError().text();
         return false;
     }
     
+    // No history row references a body any more
+    if (!query.exec("DELETE FROM response_blobs")) {
+        qWarning() << "Failed to clear response bodies:" << query.lastError().text();
+        return false;
+    }
+    query.exec("INSERT INTO response_blobs_fts (response_blobs_fts) VALUES ('delete-all')");
+    
     return true;
 }
\ No newline at end of file
@@ -3,6 +3,12 @@
 
 #include <QtCore/QObject>
 #include <QtSql/QSqlDatabase>
+#include <QtCore/QStringList>
+#include "HttpHeaders.h"
+#include "HistoryWriter.h"
+#include "ResponseBlobStore.h"
+#include "HistoryCompactor.h"
+#include "DatabaseUpgrader.h"
 
 class DatabaseManager : public QObject
 {
@@ -15,6 +21,9 @@ public:
     bool initialize(const QString &customPath);
     QSqlDatabase database() const { return m_database; }
     QString getCurrentDatabasePath() const { return m_currentDatabasePath; }
+    // False when the SQLite build lacks FTS5, and while the upgrader is still
+    // indexing existing rows; search is disabled then
+    bool isFullTextSearchAvailable() const { return m_fullTextSearchAvailable; }
     
     // Collection management
     bool createCollection(const QString &name, const QString &description = QString());
@@ -23,25 +32,70 @@ public:
     
     // Request management
     bool saveRequest(int collectionId, const QString &name, const QString &method, 
-                    const QString &url, const QString &headers, const QString &body,
+                    const QString &url, const HttpHeaders &headers, const QString &body,
                     const QString &parameters);
     bool deleteRequest(int requestId);
     bool updateRequest(int requestId, const QString &name, const QString &method,
-                      const QString &url, const QString &headers, const QString &body,
+                      const QString &url, const HttpHeaders &headers, const QString &body,
                       const QString &parameters);
     
     // History management
-    bool saveToHistory(const QString &method, const QString &url, const QString &headers,
-                      const QString &body, const QString &response, int statusCode,
-                      qint64 responseTime);
+    bool saveToHistory(const QString &method, const QString &url, const HttpHeaders &headers,
+                      const QString &body, const QByteArray &response, int statusCode,
+                      qint64 responseTime, const QString &timing = QString(), qint64 responseSize = -1);
     bool clearHistory();
+    // Only the stored preview for rows marked response_truncated
+    QByteArray loadHistoryResponse(int historyId);
+    // Cached by the history compactor after each pass
+    bool hasResponseStorageStats() const { return m_historyCompactor->hasStorageStats(); }
+    ResponseStorageStats responseStorageStats() const { return m_historyCompactor->storageStats(); }
+    // Commits queued history entries; drainHistory also stops the writer and
+    // the compactor and must be called before the application exits
+    bool flushHistory(int timeoutMs = -1);
+    bool drainHistory(int timeoutMs = -1);
+    HistoryWriter *historyWriter() const { return m_historyWriter; }
+    
+    // Retention is enforced in the background by the history compactor
+    void setRetentionPolicy(const RetentionPolicy &policy);
+    RetentionPolicy retentionPolicy() const { return m_historyCompactor->policy(); }
+    void compactHistory() { m_historyCompactor->requestCompaction(); }
+    // Also switches the file to incremental vacuum, rewriting it once
+    void reclaimHistorySpace() { m_historyCompactor->requestVacuum(); }
+    
+signals:
+    // Emitted after the corresponding change has been written
+    void collectionInserted(int collectionId, const QString &name, const QString &description);
+    void collectionUpdated(int collectionId, const QString &name, const QString &description);
+    void collectionDeleted(int collectionId);
+    void requestInserted(int requestId, int collectionId, const QString &name,
+                         const QString &method, const QString &url);
+    void requestUpdated(int requestId, const QString &name, const QString &method, const QString &url);
+    void requestDeleted(int requestId);
+    void responseStorageStatsChanged(const ResponseStorageStats &stats);
+    void fullTextSearchAvailableChanged(bool available);
+    
+private slots:
+    void onUpgradeFinished(const QString &name);
     
 private:
     explicit DatabaseManager(QObject *parent = nullptr);
     bool createTables();
+    bool ensureColumn(const QString &table, const QString &column, const QString &definition);
+    bool ensureFullTextIndex(const QString &table, const QStringList &columns);
+    void setFullTextSearchAvailable(bool available);
+    bool migrateResponseStorage();
+    bool enableIncrementalVacuum();
+    bool migrateHeaderStorage();
+    bool convertStoredHeaders(const QString &table);
     
     QSqlDatabase m_database;
     QString m_currentDatabasePath;
+    HistoryWriter *m_historyWriter;
+    HistoryCompactor *m_historyCompactor;
+    DatabaseUpgrader *m_upgrader;
+    bool m_fullTextSearchAvailable;
+    // Full-text indexes the upgrader has not finished building
+    QStringList m_pendingFullTextIndexes;
 };
 
 #endif // DATABASEMANAGER_H
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include "DatabaseUpgrader.h"
+#include "ResponseBlobStore.h"
+#include "HttpHeaders.h"
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+namespace {
+const char *ConnectionName = "DatabaseUpgraderConnection";
+// Bodies are compressed inside the transaction, so keep batches small
+const int BodyBatchSize = 100;
+const int HeaderBatchSize = 500;
+const int IndexBatchSize = 500;
+
+// Takes the write lock up front; a deferred transaction that read first
+// could fail its first write with SQLITE_BUSY_SNAPSHOT in WAL mode
+bool beginImmediate(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("BEGIN IMMEDIATE")) {
+        qWarning() << "Failed to begin upgrade transaction:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void rollback(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec("ROLLBACK");
+}
+
+bool commit(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("COMMIT")) {
+        qWarning() << "Failed to commit upgrade batch:" << query.lastError().text();
+        rollback(database);
+        return false;
+    }
+    return true;
+}
+}
+
+const char *DatabaseUpgrader::HistoryBodies = "history_bodies";
+const char *DatabaseUpgrader::HistoryHeaders = "history_headers";
+
+DatabaseUpgrader::DatabaseUpgrader(QObject *parent)
+    : QThread(parent)
+    , m_stopping(false)
+{
+}
+
+DatabaseUpgrader::~DatabaseUpgrader()
+{
+    stop();
+}
+
+void DatabaseUpgrader::start(const QString &databasePath, const StorageProfile &profile)
+{
+    stop();
+    
+    QMutexLocker locker(&m_mutex);
+    m_databasePath = databasePath;
+    m_profile = profile;
+    m_stopping = false;
+    locker.unlock();
+    
+    QThread::start(QThread::LowPriority);
+}
+
+void DatabaseUpgrader::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_stopping = true;
+    locker.unlock();
+    
+    wait();
+}
+
+bool DatabaseUpgrader::isStopping() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stopping;
+}
+
+bool DatabaseUpgrader::createTable(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec(R"(
+        CREATE TABLE IF NOT EXISTS pending_upgrades (
+            name TEXT PRIMARY KEY,
+            position INTEGER NOT NULL DEFAULT 0,
+            target INTEGER NOT NULL DEFAULT 0,
+            detail TEXT
+        )
+    )")) {
+        qWarning() << "Failed to create pending_upgrades table:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseUpgrader::addTask(QSqlDatabase &database, const QString &name, qint64 target, const QString &detail)
+{
+    QSqlQuery query(database);
+    query.prepare("INSERT OR IGNORE INTO pending_upgrades (name, target, detail) VALUES (?, ?, ?)");
+    query.addBindValue(name);
+    query.addBindValue(target);
+    query.addBindValue(detail);
+    if (!query.exec()) {
+        qWarning() << "Failed to record upgrade" << name << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseUpgrader::isPending(QSqlDatabase &database, const QString &name)
+{
+    QSqlQuery query(database);
+    query.prepare("SELECT 1 FROM pending_upgrades WHERE name = ?");
+    query.addBindValue(name);
+    return query.exec() && query.next();
+}
+
+void DatabaseUpgrader::run()
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+        database.setDatabaseName(m_databasePath);
+        if (!database.open()) {
+            qWarning() << "Failed to open database for upgrades:" << database.lastError().text();
+        } else {
+            m_profile.apply(database);
+            
+            QVector<Task> tasks;
+            QSqlQuery query(database);
+            // Search stays disabled until the full-text indexes are built, so they go first
+            if (query.exec("SELECT name, position, target, detail FROM pending_upgrades "
+                           "ORDER BY substr(name, -4) = '_fts' DESC, rowid")) {
+                while (query.next()) {
+                    Task task;
+                    task.name = query.value(0).toString();
+                    task.position = query.value(1).toLongLong();
+                    task.target = query.value(2).toLongLong();
+                    task.detail = query.value(3).toString();
+                    tasks.append(task);
+                }
+            }
+            query.finish();
+            
+            for (Task &task : tasks) {
+                if (isStopping()) {
+                    break;
+                }
+                runTask(database, task);
+            }
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+}
+
+void DatabaseUpgrader::runTask(QSqlDatabase &database, Task &task)
+{
+    while (!isStopping()) {
+        StepResult result = Failed;
+        if (task.name == HistoryBodies) {
+            result = moveResponseBodies(database, task);
+        } else if (task.name == HistoryHeaders) {
+            result = convertHistoryHeaders(database, task);
+        } else if (task.name.endsWith("_fts")) {
+            result = buildFullTextIndex(database, task);
+        } else {
+            qWarning() << "Unknown database upgrade" << task.name;
+        }
+        
+        if (result == Failed) {
+            // Left pending; the next start tries again from the saved position
+            return;
+        }
+        if (result == Done) {
+            if (finishTask(database, task)) {
+                emit taskFinished(task.name);
+            }
+            return;
+        }
+        msleep(10);
+    }
+}
+
+bool DatabaseUpgrader::savePosition(QSqlDatabase &database, const Task &task)
+{
+    QSqlQuery query(database);
+    query.prepare("UPDATE pending_upgrades SET position = ? WHERE name = ?");
+    query.addBindValue(task.position);
+    query.addBindValue(task.name);
+    if (!query.exec()) {
+        qWarning() << "Failed to save upgrade position:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseUpgrader::finishTask(QSqlDatabase &database, const Task &task)
+{
+    QSqlQuery query(database);
+    query.prepare("DELETE FROM pending_upgrades WHERE name = ?");
+    query.addBindValue(task.name);
+    if (!query.exec()) {
+        qWarning() << "Failed to finish upgrade" << task.name << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+DatabaseUpgrader::StepResult DatabaseUpgrader::moveResponseBodies(QSqlDatabase &database, Task &task)
+{
+    QSqlQuery select(database);
+    select.prepare("SELECT id, response FROM history WHERE id > ? AND response IS NOT NULL ORDER BY id LIMIT ?");
+    select.addBindValue(task.position);
+    select.addBindValue(BodyBatchSize);
+    if (!select.exec()) {
+        qWarning() << "Failed to read history for migration:" << select.lastError().text();
+        return Failed;
+    }
+    
+    QVector<QPair<qint64, QByteArray>> rows;
+    while (select.next()) {
+        rows.append(qMakePair(select.value(0).toLongLong(), select.value(1).toString().toUtf8()));
+    }
+    select.finish();
+    if (rows.isEmpty()) {
+        qInfo() << "Migrated history response storage:" << ResponseBlobStore::stats(database).toText();
+        return Done;
+    }
+    
+    if (!beginImmediate(database)) {
+        return Failed;
+    }
+    
+    // Rows are skipped if the compactor or clearHistory() removed them since
+    QSqlQuery update(database);
+    update.prepare("UPDATE history SET response_blob_id = ?, response = NULL WHERE id = ? AND response IS NOT NULL");
+    for (const auto &row : rows) {
+        qint64 blobId = ResponseBlobStore::store(database, row.second);
+        update.addBindValue(blobId > 0 ? QVariant(blobId) : QVariant(QVariant::LongLong));
+        update.addBindValue(row.first);
+        if (blobId < 0 || !update.exec()) {
+            qWarning() << "Failed to migrate history entry" << row.first << ":" << update.lastError().text();
+            rollback(database);
+            return Failed;
+        }
+    }
+    
+    task.position = rows.last().first;
+    if (!savePosition(database, task) || !commit(database)) {
+        rollback(database);
+        return Failed;
+    }
+    return Progressed;
+}
+
+DatabaseUpgrader::StepResult DatabaseUpgrader::convertHistoryHeaders(QSqlDatabase &database, Task &task)
+{
+    QSqlQuery select(database);
+    select.prepare("SELECT id, headers FROM history WHERE id > ? AND headers <> '' "
+                   "AND headers NOT LIKE '[%' ORDER BY id LIMIT ?");
+    select.addBindValue(task.position);
+    select.addBindValue(HeaderBatchSize);
+    if (!select.exec()) {
+        qWarning() << "Failed to read history headers for migration:" << select.lastError().text();
+        return Failed;
+    }
+    
+    // Converted before taking the write lock
+    QVector<QPair<qint64, QString>> rows;
+    while (select.next()) {
+        rows.append(qMakePair(select.value(0).toLongLong(),
+                              HttpHeaders::fromText(select.value(1).toString()).toJson()));
+    }
+    select.finish();
+    if (rows.isEmpty()) {
+        return Done;
+    }
+    
+    if (!beginImmediate(database)) {
+        return Failed;
+    }
+    
+    QSqlQuery update(database);
+    update.prepare("UPDATE history SET headers = ? WHERE id = ? AND headers NOT LIKE '[%'");
+    for (const auto &row : rows) {
+        update.addBindValue(row.second);
+        update.addBindValue(row.first);
+        if (!update.exec()) {
+            qWarning() << "Failed to migrate history headers" << row.first << ":" << update.lastError().text();
+            rollback(database);
+            return Failed;
+        }
+    }
+    
+    task.position = rows.last().first;
+    if (!savePosition(database, task) || !commit(database)) {
+        rollback(database);
+        return Failed;
+    }
+    return Progressed;
+}
+
+DatabaseUpgrader::StepResult DatabaseUpgrader::buildFullTextIndex(QSqlDatabase &database, Task &task)
+{
+    const QString table = task.name.left(task.name.size() - 4);
+    
+    if (!beginImmediate(database)) {
+        return Failed;
+    }
+    
+    QSqlQuery query(database);
+    query.prepare(QString("SELECT MAX(id) FROM (SELECT id FROM %1 WHERE id > ? AND id <= ? ORDER BY id LIMIT ?)")
+                      .arg(table));
+    query.addBindValue(task.position);
+    query.addBindValue(task.target);
+    query.addBindValue(IndexBatchSize);
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Failed to read" << table << "for indexing:" << query.lastError().text();
+        rollback(database);
+        return Failed;
+    }
+    if (query.value(0).isNull()) {
+        rollback(database);
+        return Done;
+    }
+    qint64 batchEnd = query.value(0).toLongLong();
+    query.finish();
+    
+    // The triggers skip rows in this range, so each row is indexed once;
+    // moving the position in the same transaction hands the batch over to them
+    query.prepare(QString("INSERT INTO %1(rowid, %2) SELECT id, %2 FROM %3 WHERE id > ? AND id <= ?")
+                      .arg(task.name, task.detail, table));
+    query.addBindValue(task.position);
+    query.addBindValue(batchEnd);
+    if (!query.exec()) {
+        qWarning() << "Failed to build full-text index" << task.name << ":" << query.lastError().text();
+        rollback(database);
+        return Failed;
+    }
+    
+    task.position = batchEnd;
+    if (!savePosition(database, task) || !commit(database)) {
+        rollback(database);
+        return Failed;
+    }
+    return Progressed;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef DATABASEUPGRADER_H
+#define DATABASEUPGRADER_H
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtSql/QSqlDatabase>
+#include "StorageProfile.h"
+
+// Finishes schema upgrades that touch every row of a table on a background
+// thread with its own database connection, so the first start after an
+// upgrade does not freeze the UI. DatabaseManager records the work in the
+// pending_upgrades table; it is done in small batches, each in a short
+// transaction that also saves how far the task got, so an interrupted
+// upgrade resumes where it stopped. Readers fall back to the old format
+// for rows that have not been upgraded yet.
+class DatabaseUpgrader : public QThread
+{
+    Q_OBJECT
+    
+public:
+    // Moves inline history responses into response_blobs
+    static const char *HistoryBodies;
+    // Rewrites "Name: value" history headers as JSON
+    static const char *HistoryHeaders;
+    // Any other task name is a full-text index "<table>_fts" to fill from
+    // <table>; its detail is the indexed column list
+    
+    explicit DatabaseUpgrader(QObject *parent = nullptr);
+    ~DatabaseUpgrader();
+    
+    // Returns right away when nothing is pending
+    void start(const QString &databasePath, const StorageProfile &profile = StorageProfile());
+    // An upgrade in progress stops at the next batch boundary
+    void stop();
+    
+    static bool createTable(QSqlDatabase &database);
+    // Records a task; target is the highest row id it has to cover, if it needs one
+    static bool addTask(QSqlDatabase &database, const QString &name, qint64 target = 0,
+                        const QString &detail = QString());
+    static bool isPending(QSqlDatabase &database, const QString &name);
+    
+signals:
+    void taskFinished(const QString &name);
+    
+protected:
+    void run() override;
+    
+private:
+    struct Task
+    {
+        QString name;
+        // Highest row id already done
+        qint64 position;
+        qint64 target;
+        QString detail;
+    };
+    
+    enum StepResult {
+        Progressed,
+        Done,
+        Failed
+    };
+    
+    void runTask(QSqlDatabase &database, Task &task);
+    StepResult moveResponseBodies(QSqlDatabase &database, Task &task);
+    StepResult convertHistoryHeaders(QSqlDatabase &database, Task &task);
+    StepResult buildFullTextIndex(QSqlDatabase &database, Task &task);
+    // Saves the task's position inside the batch's transaction
+    bool savePosition(QSqlDatabase &database, const Task &task);
+    bool finishTask(QSqlDatabase &database, const Task &task);
+    bool isStopping() const;
+    
+    QString m_databasePath;
+    StorageProfile m_profile;
+    mutable QMutex m_mutex;
+    bool m_stopping;
+};
+
+#endif // DATABASEUPGRADER_H
\ No newline at end of file
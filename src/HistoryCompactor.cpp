@@ -0,0 +1,553 @@
+#include "HistoryCompactor.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStorageInfo>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+namespace {
+const char *ConnectionName = "HistoryCompactorConnection";
+const int BatchSize = 500;
+// Pages returned to the file system per incremental_vacuum call
+const int VacuumPagesPerStep = 1000;
+
+// Takes the write lock immediately, so nothing read inside the transaction
+// can change before it commits
+bool beginImmediate(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("BEGIN IMMEDIATE")) {
+        qWarning() << "Failed to begin compaction transaction:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void rollback(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec("ROLLBACK");
+}
+
+bool commit(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("COMMIT")) {
+        qWarning() << "Failed to commit compaction batch:" << query.lastError().text();
+        rollback(database);
+        return false;
+    }
+    return true;
+}
+}
+
+HistoryCompactor::HistoryCompactor(QObject *parent)
+    : QThread(parent)
+    , m_hasStorageStats(false)
+    , m_intervalMinutes(10)
+    , m_compactionRequested(false)
+    , m_vacuumRequested(false)
+    , m_stopping(false)
+{
+    qRegisterMetaType<ResponseStorageStats>();
+}
+
+HistoryCompactor::~HistoryCompactor()
+{
+    stop();
+}
+
+void HistoryCompactor::start(const QString &databasePath, const StorageProfile &profile)
+{
+    stop();
+    
+    QMutexLocker locker(&m_mutex);
+    m_databasePath = databasePath;
+    m_profile = profile;
+    m_stopping = false;
+    // The first pass runs right away to catch up after downtime
+    m_compactionRequested = true;
+    locker.unlock();
+    
+    QThread::start(QThread::LowestPriority);
+}
+
+void HistoryCompactor::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_stopping = true;
+    m_wakeCondition.wakeOne();
+    locker.unlock();
+    
+    // A pass in progress stops at the next batch boundary
+    wait();
+}
+
+void HistoryCompactor::setPolicy(const RetentionPolicy &policy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_policy = policy;
+}
+
+RetentionPolicy HistoryCompactor::policy() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_policy;
+}
+
+void HistoryCompactor::setInterval(int minutes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_intervalMinutes = qMax(1, minutes);
+    m_wakeCondition.wakeOne();
+}
+
+void HistoryCompactor::requestCompaction()
+{
+    QMutexLocker locker(&m_mutex);
+    m_compactionRequested = true;
+    m_wakeCondition.wakeOne();
+}
+
+void HistoryCompactor::requestVacuum()
+{
+    QMutexLocker locker(&m_mutex);
+    m_vacuumRequested = true;
+    m_compactionRequested = true;
+    m_wakeCondition.wakeOne();
+}
+
+bool HistoryCompactor::hasStorageStats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hasStorageStats;
+}
+
+ResponseStorageStats HistoryCompactor::storageStats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_storageStats;
+}
+
+bool HistoryCompactor::isStopping() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stopping;
+}
+
+void HistoryCompactor::run()
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+        database.setDatabaseName(m_databasePath);
+        if (!database.open()) {
+            qWarning() << "Failed to open database for history compaction:" << database.lastError().text();
+        } else {
+            m_profile.apply(database);
+            
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopping) {
+                if (!m_compactionRequested) {
+                    m_wakeCondition.wait(&m_mutex, (unsigned long)m_intervalMinutes * 60 * 1000);
+                    if (m_stopping) {
+                        break;
+                    }
+                }
+                const bool vacuumRequested = m_vacuumRequested;
+                m_compactionRequested = false;
+                m_vacuumRequested = false;
+                locker.unlock();
+                
+                compact(database, vacuumRequested);
+                
+                locker.relock();
+            }
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+}
+
+void HistoryCompactor::compact(QSqlDatabase &database, bool vacuumRequested)
+{
+    const RetentionPolicy rules = policy();
+    qint64 deletedEntries = 0;
+    
+    // The one-off VACUUM is only worth its cost once history will actually be
+    // deleted, or when the user asks to reclaim space
+    if ((rules.isEnabled() || vacuumRequested) && !isStopping()) {
+        enableIncrementalVacuum(database);
+    }
+    
+    if (rules.maxAgeDays > 0) {
+        QString cutoff = QDateTime::currentDateTimeUtc().addDays(-rules.maxAgeDays).toString("yyyy-MM-dd HH:mm:ss");
+        deletedEntries += deleteInBatches(database,
+            "SELECT id FROM history WHERE created_at < ? ORDER BY id LIMIT ?", QVariantList() << cutoff);
+    }
+    
+    if (rules.keepPerUrl > 0 && !isStopping()) {
+        deletedEntries += deleteOlderPerUrl(database, rules.keepPerUrl);
+    }
+    
+    if (rules.maxEntries > 0 && !isStopping()) {
+        // Everything older than the newest maxEntries rows
+        deletedEntries += deleteInBatches(database, R"(
+            SELECT id FROM history
+            WHERE id <= (SELECT id FROM history ORDER BY id DESC LIMIT 1 OFFSET ?)
+            ORDER BY id
+            LIMIT ?
+        )", QVariantList() << rules.maxEntries);
+    }
+    
+    if (rules.maxTotalBytes > 0 && !isStopping()) {
+        deletedEntries += deleteToSize(database, rules.maxTotalBytes);
+    }
+    
+    // One sweep for everything the rules above left unreferenced
+    qint64 deletedBodies = isStopping() ? 0 : deleteUnreferencedBodies(database);
+    
+    qint64 freedPages = isStopping() ? 0 : incrementalVacuum(database);
+    
+    if (deletedEntries > 0 || deletedBodies > 0 || freedPages > 0) {
+        qInfo() << "History compaction removed" << deletedEntries << "entries and"
+                << deletedBodies << "response bodies, freed" << freedPages << "pages";
+        emit compacted(deletedEntries, deletedBodies, freedPages);
+    }
+    
+    if (isStopping()) {
+        return;
+    }
+    
+    // Measured here so the settings dialog never runs the full join itself
+    ResponseStorageStats stats = ResponseBlobStore::stats(database);
+    QMutexLocker locker(&m_mutex);
+    m_storageStats = stats;
+    m_hasStorageStats = true;
+    locker.unlock();
+    emit storageStatsChanged(stats);
+}
+
+qint64 HistoryCompactor::deleteInBatches(QSqlDatabase &database, const QString &idQuery, const QVariantList &values)
+{
+    qint64 deleted = 0;
+    QSqlQuery select(database);
+    QSqlQuery remove(database);
+    select.prepare(idQuery);
+    remove.prepare("DELETE FROM history WHERE id = ?");
+    
+    while (!isStopping()) {
+        for (const QVariant &value : values) {
+            select.addBindValue(value);
+        }
+        select.addBindValue(BatchSize);
+        if (!select.exec()) {
+            qWarning() << "Failed to select history for compaction:" << select.lastError().text();
+            break;
+        }
+        
+        QVariantList ids;
+        while (select.next()) {
+            ids << select.value(0);
+        }
+        select.finish();
+        if (ids.isEmpty()) {
+            break;
+        }
+        
+        // One short transaction per batch keeps the write lock brief
+        if (!beginImmediate(database)) {
+            break;
+        }
+        remove.addBindValue(ids);
+        if (!remove.execBatch()) {
+            qWarning() << "Failed to delete history batch:" << remove.lastError().text();
+            rollback(database);
+            break;
+        }
+        if (!commit(database)) {
+            break;
+        }
+        deleted += ids.size();
+        
+        if (ids.size() < BatchSize) {
+            break;
+        }
+        msleep(10);
+    }
+    
+    return deleted;
+}
+
+qint64 HistoryCompactor::deleteOlderPerUrl(QSqlDatabase &database, int keepPerUrl)
+{
+    // Only URLs with more than keepPerUrl entries; one pass over idx_history_url
+    QSqlQuery urls(database);
+    urls.prepare("SELECT url FROM history GROUP BY url HAVING COUNT(*) > ?");
+    urls.addBindValue(keepPerUrl);
+    if (!urls.exec()) {
+        qWarning() << "Failed to find URLs to trim:" << urls.lastError().text();
+        return 0;
+    }
+    
+    QStringList trimmed;
+    while (urls.next()) {
+        trimmed << urls.value(0).toString();
+    }
+    urls.finish();
+    
+    qint64 deleted = 0;
+    QSqlQuery cutoff(database);
+    cutoff.prepare("SELECT id FROM history WHERE url = ? ORDER BY id DESC LIMIT 1 OFFSET ?");
+    
+    for (const QString &url : trimmed) {
+        if (isStopping()) {
+            break;
+        }
+        
+        // The oldest entry to keep, found once per URL by walking its index range
+        cutoff.addBindValue(url);
+        cutoff.addBindValue(keepPerUrl - 1);
+        if (!cutoff.exec()) {
+            qWarning() << "Failed to find history cutoff:" << cutoff.lastError().text();
+            break;
+        }
+        if (!cutoff.next()) {
+            cutoff.finish();
+            continue;
+        }
+        const qint64 oldestKeptId = cutoff.value(0).toLongLong();
+        cutoff.finish();
+        
+        deleted += deleteInBatches(database, "SELECT id FROM history WHERE url = ? AND id < ? ORDER BY id LIMIT ?",
+                                   QVariantList() << url << oldestKeptId);
+    }
+    
+    return deleted;
+}
+
+qint64 HistoryCompactor::deleteUnreferencedBodies(QSqlDatabase &database)
+{
+    qint64 deleted = 0;
+    qint64 lastId = 0;
+    QSqlQuery select(database);
+    QSqlQuery unindex(database);
+    QSqlQuery remove(database);
+    select.prepare(R"(
+        SELECT b.id, b.data FROM response_blobs b
+        WHERE b.id > ? AND NOT EXISTS (SELECT 1 FROM history h WHERE h.response_blob_id = b.id)
+        ORDER BY b.id
+        LIMIT ?
+    )");
+    // The body index is contentless, so removal needs the original text
+    unindex.prepare("INSERT INTO response_blobs_fts (response_blobs_fts, rowid, body) VALUES ('delete', ?, ?)");
+    // Checked again under the write lock: the history writer may have
+    // deduplicated a new entry onto a candidate since it was selected
+    remove.prepare("DELETE FROM response_blobs WHERE id = ? "
+                   "AND NOT EXISTS (SELECT 1 FROM history WHERE response_blob_id = ?)");
+    
+    while (!isStopping()) {
+        // Candidates are read and decompressed without holding the write lock
+        select.addBindValue(lastId);
+        select.addBindValue(BatchSize);
+        if (!select.exec()) {
+            qWarning() << "Failed to find unreferenced response bodies:" << select.lastError().text();
+            break;
+        }
+        
+        QVector<QPair<qint64, QString>> candidates;
+        while (select.next()) {
+            candidates.append(qMakePair(select.value(0).toLongLong(),
+                                        QString::fromUtf8(qUncompress(select.value(1).toByteArray()))));
+        }
+        select.finish();
+        if (candidates.isEmpty()) {
+            break;
+        }
+        lastId = candidates.last().first;
+        
+        if (!beginImmediate(database)) {
+            break;
+        }
+        
+        qint64 removed = 0;
+        bool failed = false;
+        for (const auto &candidate : candidates) {
+            remove.addBindValue(candidate.first);
+            remove.addBindValue(candidate.first);
+            if (!remove.exec()) {
+                qWarning() << "Failed to delete response body:" << remove.lastError().text();
+                failed = true;
+                break;
+            }
+            if (remove.numRowsAffected() != 1) {
+                continue;
+            }
+            
+            unindex.addBindValue(candidate.first);
+            unindex.addBindValue(candidate.second);
+            if (!unindex.exec()) {
+                qWarning() << "Failed to unindex response body:" << unindex.lastError().text();
+            }
+            ++removed;
+        }
+        
+        if (failed) {
+            rollback(database);
+            break;
+        }
+        if (!commit(database)) {
+            break;
+        }
+        deleted += removed;
+        
+        if (candidates.size() < BatchSize) {
+            break;
+        }
+        msleep(10);
+    }
+    
+    return deleted;
+}
+
+qint64 HistoryCompactor::deleteToSize(QSqlDatabase &database, qint64 maxTotalBytes)
+{
+    // Measured once; each batch then subtracts what it frees
+    QSqlQuery query(database);
+    if (!query.exec("SELECT COALESCE(SUM(b.compressed_size), 0) FROM response_blobs b "
+                    "WHERE EXISTS (SELECT 1 FROM history h WHERE h.response_blob_id = b.id)") || !query.next()) {
+        qWarning() << "Failed to measure history size:" << query.lastError().text();
+        return 0;
+    }
+    qint64 totalBytes = query.value(0).toLongLong();
+    query.finish();
+    
+    QSqlQuery oldest(database);
+    QSqlQuery freed(database);
+    oldest.prepare("SELECT id FROM history ORDER BY id LIMIT ?");
+    // Bodies only the batch references; an estimate, as the writer may reuse
+    // one before the batch is deleted, and the body sweep afterwards decides
+    freed.prepare(R"(
+        SELECT COALESCE(SUM(b.compressed_size), 0) FROM response_blobs b
+        WHERE b.id IN (SELECT response_blob_id FROM history WHERE id <= ?)
+          AND NOT EXISTS (SELECT 1 FROM history h WHERE h.response_blob_id = b.id AND h.id > ?)
+    )");
+    
+    qint64 deleted = 0;
+    while (totalBytes > maxTotalBytes && !isStopping()) {
+        oldest.addBindValue(BatchSize);
+        if (!oldest.exec()) {
+            qWarning() << "Failed to select history for compaction:" << oldest.lastError().text();
+            break;
+        }
+        qint64 lastId = 0;
+        while (oldest.next()) {
+            lastId = oldest.value(0).toLongLong();
+        }
+        oldest.finish();
+        if (lastId == 0) {
+            break;
+        }
+        
+        freed.addBindValue(lastId);
+        freed.addBindValue(lastId);
+        if (!freed.exec() || !freed.next()) {
+            qWarning() << "Failed to measure history batch:" << freed.lastError().text();
+            break;
+        }
+        qint64 freedBytes = freed.value(0).toLongLong();
+        freed.finish();
+        
+        qint64 batchDeleted = deleteInBatches(database, "SELECT id FROM history WHERE id <= ? ORDER BY id LIMIT ?",
+                                              QVariantList() << lastId);
+        if (batchDeleted == 0) {
+            break;
+        }
+        deleted += batchDeleted;
+        totalBytes -= freedBytes;
+    }
+    
+    return deleted;
+}
+
+bool HistoryCompactor::enableIncrementalVacuum(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("PRAGMA auto_vacuum") || !query.next()) {
+        qWarning() << "Failed to read auto_vacuum mode:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() == 2) {
+        return true;
+    }
+    query.finish();
+    
+    // The rewrite needs room for a second copy of the file
+    QFileInfo file(database.databaseName());
+    QStorageInfo storage(file.absolutePath());
+    if (storage.isValid() && storage.bytesAvailable() < file.size()) {
+        qWarning() << "Not enough free disk space to enable incremental vacuum: need"
+                   << file.size() << "bytes, have" << storage.bytesAvailable();
+        return false;
+    }
+    
+    // VACUUM rewrites the whole file, which on a large history takes a while.
+    // The UI keeps reading through WAL meanwhile; the history writer holds its
+    // batches until maintenanceChanged(false) instead of timing out on the lock.
+    // It also reclaims what the blob migration freed.
+    emit maintenanceChanged(true);
+    QElapsedTimer timer;
+    timer.start();
+    bool vacuumed = query.exec("PRAGMA auto_vacuum = INCREMENTAL") && query.exec("VACUUM");
+    emit maintenanceChanged(false);
+    if (!vacuumed) {
+        qWarning() << "Failed to enable incremental vacuum:" << query.lastError().text();
+        return false;
+    }
+    
+    qInfo() << "Switched the database to incremental vacuum in" << timer.elapsed() << "ms";
+    return true;
+}
+
+qint64 HistoryCompactor::incrementalVacuum(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    
+    // 2 = INCREMENTAL; other modes cannot shrink the file piecewise
+    if (!query.exec("PRAGMA auto_vacuum") || !query.next() || query.value(0).toInt() != 2) {
+        return 0;
+    }
+    query.finish();
+    
+    qint64 freed = 0;
+    while (!isStopping()) {
+        if (!query.exec("PRAGMA freelist_count") || !query.next()) {
+            break;
+        }
+        qint64 freePages = query.value(0).toLongLong();
+        query.finish();
+        if (freePages == 0) {
+            break;
+        }
+        
+        if (!query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(VacuumPagesPerStep))) {
+            qWarning() << "Incremental vacuum failed:" << query.lastError().text();
+            break;
+        }
+        while (query.next()) {
+        }
+        query.finish();
+        freed += qMin<qint64>(freePages, VacuumPagesPerStep);
+        msleep(10);
+    }
+    
+    return freed;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef HISTORYCOMPACTOR_H
+#define HISTORYCOMPACTOR_H
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QVariant>
+#include <QtSql/QSqlDatabase>
+#include "StorageProfile.h"
+#include "ResponseBlobStore.h"
+
+// Limits on how much history is kept. A limit of 0 disables that rule; all
+// rules start disabled so history is only ever deleted once a user opts in.
+struct RetentionPolicy
+{
+    RetentionPolicy()
+        : maxEntries(0), maxAgeDays(0)
+        , maxTotalBytes(0), keepPerUrl(0) {}
+    
+    bool isEnabled() const { return maxEntries > 0 || maxAgeDays > 0 || maxTotalBytes > 0 || keepPerUrl > 0; }
+    
+    qint64 maxEntries;
+    int maxAgeDays;
+    // Compressed size of the stored response bodies
+    qint64 maxTotalBytes;
+    // Only the newest keepPerUrl entries of each URL are kept
+    int keepPerUrl;
+};
+
+// Enforces a RetentionPolicy on a background thread with its own database
+// connection. Old entries are deleted in small batches, each in its own
+// transaction, so the history writer and the UI are never locked out for
+// long. Response bodies no longer referenced are removed afterwards and the
+// freed pages are returned to the file system with incremental vacuum. Each
+// pass ends by measuring response storage, which is cached for the UI.
+class HistoryCompactor : public QThread
+{
+    Q_OBJECT
+    
+public:
+    explicit HistoryCompactor(QObject *parent = nullptr);
+    ~HistoryCompactor();
+    
+    void start(const QString &databasePath, const StorageProfile &profile = StorageProfile());
+    void stop();
+    
+    void setPolicy(const RetentionPolicy &policy);
+    RetentionPolicy policy() const;
+    // Minutes between compaction passes
+    void setInterval(int minutes);
+    
+    // Runs a pass now instead of waiting for the interval
+    void requestCompaction();
+    // Runs a pass now that also switches the file to incremental vacuum if
+    // needed, which otherwise only happens once retention is enabled
+    void requestVacuum();
+    
+    // As of the last pass; false until the first pass has finished
+    bool hasStorageStats() const;
+    ResponseStorageStats storageStats() const;
+    
+signals:
+    void compacted(qint64 deletedEntries, qint64 deletedBodies, qint64 freedPages);
+    void storageStatsChanged(const ResponseStorageStats &stats);
+    // Emitted from the compactor thread around a full VACUUM, which holds
+    // the write lock throughout; connect with Qt::DirectConnection
+    void maintenanceChanged(bool running);
+    
+protected:
+    void run() override;
+    
+private:
+    void compact(QSqlDatabase &database, bool vacuumRequested);
+    // Deletes the rows selected by idQuery in batches until it returns none
+    qint64 deleteInBatches(QSqlDatabase &database, const QString &idQuery, const QVariantList &values);
+    // Deletes all but the newest keepPerUrl entries of each URL
+    qint64 deleteOlderPerUrl(QSqlDatabase &database, int keepPerUrl);
+    qint64 deleteUnreferencedBodies(QSqlDatabase &database);
+    // Deletes the oldest entries until their bodies fit in maxTotalBytes
+    qint64 deleteToSize(QSqlDatabase &database, qint64 maxTotalBytes);
+    // Switches an existing file to incremental auto-vacuum with a one-off VACUUM
+    bool enableIncrementalVacuum(QSqlDatabase &database);
+    qint64 incrementalVacuum(QSqlDatabase &database);
+    bool isStopping() const;
+    
+    QString m_databasePath;
+    StorageProfile m_profile;
+    RetentionPolicy m_policy;
+    ResponseStorageStats m_storageStats;
+    bool m_hasStorageStats;
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    int m_intervalMinutes;
+    bool m_compactionRequested;
+    bool m_vacuumRequested;
+    bool m_stopping;
+};
+
+#endif // HISTORYCOMPACTOR_H
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "HistoryWriter.h"
+#include "ResponseBlobStore.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+#include <climits>
+
+namespace {
+const char *ConnectionName = "HistoryWriterConnection";
+// A failed batch is put back and tried again this many times before it is dropped
+const int MaxWriteAttempts = 5;
+const int RetryDelayMs = 200;
+
+QString currentTimestamp()
+{
+    return QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd HH:mm:ss");
+}
+
+void rollback(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec("ROLLBACK");
+}
+}
+
+HistoryWriter::HistoryWriter(QObject *parent)
+    : QThread(parent)
+    , m_enqueuedCount(0)
+    , m_processedCount(0)
+    , m_batchSize(64)
+    , m_flushIntervalMs(1000)
+    , m_flushRequested(false)
+    , m_maintenanceRunning(false)
+    , m_stopping(false)
+{
+}
+
+HistoryWriter::~HistoryWriter()
+{
+    drain();
+}
+
+void HistoryWriter::start(const QString &databasePath, const StorageProfile &profile)
+{
+    if (isRunning()) {
+        drain();
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_databasePath = databasePath;
+    m_profile = profile;
+    m_stopping = false;
+    m_flushRequested = false;
+    locker.unlock();
+    
+    QThread::start(QThread::LowPriority);
+}
+
+void HistoryWriter::setBatchSize(int entries)
+{
+    QMutexLocker locker(&m_mutex);
+    m_batchSize = qMax(1, entries);
+    m_wakeCondition.wakeOne();
+}
+
+int HistoryWriter::batchSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_batchSize;
+}
+
+void HistoryWriter::setFlushInterval(int milliseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_flushIntervalMs = qMax(0, milliseconds);
+    m_wakeCondition.wakeOne();
+}
+
+int HistoryWriter::flushInterval() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_flushIntervalMs;
+}
+
+void HistoryWriter::enqueue(const HistoryEntry &entry)
+{
+    HistoryEntry queued = entry;
+    if (queued.createdAt.isEmpty()) {
+        queued.createdAt = currentTimestamp();
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.isEmpty()) {
+        m_oldestQueued.start();
+    }
+    m_queue.append(queued);
+    ++m_enqueuedCount;
+    
+    // Only wake the thread when there is something for it to decide
+    if (m_queue.size() == 1 || m_queue.size() >= m_batchSize) {
+        m_wakeCondition.wakeOne();
+    }
+}
+
+int HistoryWriter::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_enqueuedCount - m_processedCount);
+}
+
+void HistoryWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_wakeCondition.wakeOne();
+}
+
+void HistoryWriter::setMaintenanceRunning(bool running)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maintenanceRunning = running;
+    m_wakeCondition.wakeOne();
+}
+
+bool HistoryWriter::waitForFlushed(int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    QMutexLocker locker(&m_mutex);
+    const quint64 target = m_enqueuedCount;
+    m_flushRequested = true;
+    m_wakeCondition.wakeOne();
+    
+    while (m_processedCount < target) {
+        if (!isRunning()) {
+            return false;
+        }
+        
+        unsigned long wait = ULONG_MAX;
+        if (timeoutMs >= 0) {
+            qint64 remaining = timeoutMs - timer.elapsed();
+            if (remaining <= 0) {
+                return false;
+            }
+            wait = (unsigned long)remaining;
+        }
+        m_flushedCondition.wait(&m_mutex, wait);
+    }
+    
+    return true;
+}
+
+bool HistoryWriter::drain(int timeoutMs)
+{
+    if (!isRunning()) {
+        return pendingCount() == 0;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_stopping = true;
+    m_wakeCondition.wakeOne();
+    locker.unlock();
+    
+    // The thread writes out the remaining queue before it exits
+    if (timeoutMs < 0) {
+        wait();
+    } else if (!wait((unsigned long)timeoutMs)) {
+        qWarning() << "History writer did not finish within" << timeoutMs << "ms";
+        return false;
+    }
+    
+    return pendingCount() == 0;
+}
+
+void HistoryWriter::run()
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+        database.setDatabaseName(m_databasePath);
+        if (!database.open()) {
+            qWarning() << "Failed to open history database:" << database.lastError().text();
+        } else {
+            m_profile.apply(database);
+        }
+        
+        // A batch that failed to commit is kept here and retried on its own;
+        // entries queued meanwhile wait for the next batch
+        QVector<HistoryEntry> batch;
+        int failedAttempts = 0;
+        QMutexLocker locker(&m_mutex);
+        forever {
+            if (batch.isEmpty()) {
+                while (m_queue.isEmpty() && !m_stopping) {
+                    m_wakeCondition.wait(&m_mutex);
+                }
+                if (m_queue.isEmpty()) {
+                    break;
+                }
+                
+                // Let a batch build up unless it is full or someone is waiting for it
+                while (m_queue.size() < m_batchSize && !m_flushRequested && !m_stopping) {
+                    qint64 remaining = m_flushIntervalMs - m_oldestQueued.elapsed();
+                    if (remaining <= 0) {
+                        break;
+                    }
+                    m_wakeCondition.wait(&m_mutex, (unsigned long)remaining);
+                }
+                
+                batch.swap(m_queue);
+                m_flushRequested = false;
+            }
+            
+            while (m_maintenanceRunning) {
+                m_wakeCondition.wait(&m_mutex);
+            }
+            locker.unlock();
+            
+            bool written = database.isOpen() && writeEntries(database, batch);
+            if (!written && ++failedAttempts < MaxWriteAttempts) {
+                // Usually another connection holding the write lock; back off
+                msleep((unsigned long)(RetryDelayMs * failedAttempts));
+                locker.relock();
+                continue;
+            }
+            
+            if (!written) {
+                qWarning() << "Dropped" << batch.size() << "history entries after" << failedAttempts << "attempts";
+            }
+            failedAttempts = 0;
+            
+            locker.relock();
+            m_processedCount += batch.size();
+            batch.clear();
+            m_flushedCondition.wakeAll();
+        }
+        
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(ConnectionName);
+    
+    // Wake anyone still waiting so they can see the thread has stopped
+    QMutexLocker locker(&m_mutex);
+    m_flushedCondition.wakeAll();
+}
+
+bool HistoryWriter::writeEntries(QSqlDatabase database, const QVector<HistoryEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return true;
+    }
+    
+    // Take the write lock up front. A deferred transaction would start as a
+    // reader for the blob hash lookups, and in WAL mode its first write fails
+    // with SQLITE_BUSY_SNAPSHOT if another connection committed meanwhile,
+    // which busy_timeout does not retry.
+    QSqlQuery begin(database);
+    if (!begin.exec("BEGIN IMMEDIATE")) {
+        qWarning() << "Failed to begin history transaction:" << begin.lastError().text();
+        return false;
+    }
+    
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO history (method, url, headers, body, response_blob_id, response_size, response_truncated, "
+                  "status_code, response_time, timing, created_at) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    
+    for (const HistoryEntry &entry : entries) {
+        // Bodies are stored once per distinct content; the row only references it
+        qint64 blobId = ResponseBlobStore::store(database, entry.response);
+        if (blobId < 0) {
+            rollback(database);
+            return false;
+        }
+        
+        query.addBindValue(entry.method);
+        query.addBindValue(entry.url);
+        query.addBindValue(entry.headers);
+        query.addBindValue(entry.body);
+        query.addBindValue(blobId > 0 ? QVariant(blobId) : QVariant(QVariant::LongLong));
+        query.addBindValue(entry.responseSize);
+        query.addBindValue(entry.responseTruncated ? 1 : 0);
+        query.addBindValue(entry.statusCode);
+        query.addBindValue(entry.responseTime);
+        query.addBindValue(entry.timing);
+        query.addBindValue(entry.createdAt.isEmpty() ? currentTimestamp() : entry.createdAt);
+        
+        if (!query.exec()) {
+            qWarning() << "Failed to save to history:" << query.lastError().text();
+            rollback(database);
+            return false;
+        }
+    }
+    
+    QSqlQuery commit(database);
+    if (!commit.exec("COMMIT")) {
+        qWarning() << "Failed to commit history batch:" << commit.lastError().text();
+        rollback(database);
+        return false;
+    }
+    
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef HISTORYWRITER_H
+#define HISTORYWRITER_H
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVector>
+#include <QtSql/QSqlDatabase>
+#include "StorageProfile.h"
+
+struct HistoryEntry
+{
+    HistoryEntry() : responseSize(0), responseTruncated(false), statusCode(0), responseTime(0) {}
+    
+    QString method;
+    QString url;
+    // JSON as written by HttpHeaders::toJson()
+    QString headers;
+    QString body;
+    QByteArray response;
+    // Size of the whole body; when it was spilled to disk, response holds
+    // only its first bytes and responseTruncated is set
+    qint64 responseSize;
+    bool responseTruncated;
+    int statusCode;
+    qint64 responseTime;
+    QString timing;
+    // UTC, in the same format as SQLite's CURRENT_TIMESTAMP
+    QString createdAt;
+};
+
+// Writes history entries on a background thread with its own database
+// connection. Entries are queued without blocking and committed in one
+// transaction per batch, once batchSize entries are waiting or the oldest has
+// waited flushInterval milliseconds. A batch that fails to commit is requeued
+// and retried a few times before it is dropped.
+class HistoryWriter : public QThread
+{
+    Q_OBJECT
+    
+public:
+    explicit HistoryWriter(QObject *parent = nullptr);
+    ~HistoryWriter();
+    
+    // Starts the writer thread against the given SQLite database file
+    void start(const QString &databasePath, const StorageProfile &profile = StorageProfile());
+    
+    void setBatchSize(int entries);
+    int batchSize() const;
+    void setFlushInterval(int milliseconds);
+    int flushInterval() const;
+    
+    void enqueue(const HistoryEntry &entry);
+    int pendingCount() const;
+    
+    // Asks the writer to commit whatever is queued without waiting
+    void flush();
+    // Blocks until everything queued before the call is committed;
+    // a negative timeout waits indefinitely
+    bool waitForFlushed(int timeoutMs = -1);
+    // Flushes, then stops the thread; used on shutdown
+    bool drain(int timeoutMs = -1);
+    
+    // While set, batches are held instead of written, e.g. while a VACUUM
+    // holds the write lock for longer than the retries would wait
+    void setMaintenanceRunning(bool running);
+    
+    // Inserts entries in a single transaction on the given connection
+    static bool writeEntries(QSqlDatabase database, const QVector<HistoryEntry> &entries);
+    
+protected:
+    void run() override;
+    
+private:
+    QString m_databasePath;
+    StorageProfile m_profile;
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    QWaitCondition m_flushedCondition;
+    QVector<HistoryEntry> m_queue;
+    QElapsedTimer m_oldestQueued;
+    quint64 m_enqueuedCount;
+    quint64 m_processedCount;
+    int m_batchSize;
+    int m_flushIntervalMs;
+    bool m_flushRequested;
+    bool m_maintenanceRunning;
+    bool m_stopping;
+};
+
+#endif // HISTORYWRITER_H
\ No newline at end of file
@@ -1,126 +1,101 @@
 #include "HttpClient.h"
 #include "DatabaseManager.h"
-#include <QtCore/QUrl>
-#include <QtCore/QUrlQuery>
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonObject>
-#include <QtCore/QJsonParseError>
-#include <QtCore/QElapsedTimer>
-#include <QtNetwork/QNetworkRequest>
+#include "ConfigManager.h"
 
 HttpClient::HttpClient(QObject *parent)
     : QObject(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_currentReply(nullptr)
-    , m_startTime(0)
+    , m_executor(new RequestExecutor(this))
+    , m_retryPolicy(ConfigManager::instance()->getRetryPolicy())
+    , m_nextRequestId(1)
 {
+    connect(m_executor, &RequestExecutor::finished, this, &HttpClient::onExecutorFinished);
+    connect(m_executor, &RequestExecutor::chunkReceived, this, [this](int executorId, const QByteArray &chunk) {
+        emit responseChunk(m_executorIds.value(executorId), chunk);
+    });
+    connect(m_executor, &RequestExecutor::downloadProgress, this, [this](int executorId, qint64 received, qint64 total) {
+        emit downloadProgress(m_executorIds.value(executorId), received, total);
+    });
+    connect(m_executor, &RequestExecutor::retrying, this, [this](int executorId, int nextAttempt, qint64 backoffMs) {
+        emit requestRetrying(m_executorIds.value(executorId), nextAttempt, backoffMs);
+    });
 }
 
-void HttpClient::sendRequest(const QString &method, const QString &url, 
-                           const QString &headers, const QString &body)
+int HttpClient::sendRequest(const QString &method, const QString &url,
+                            const HttpHeaders &headers, const QString &body)
 {
-    if (m_currentReply) {
-        m_currentReply->abort();
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
-    }
-    
-    QNetworkRequest request = createRequest(url, headers);
-    QByteArray requestBody = body.toUtf8();
-    
-    m_startTime = QDateTime::currentMSecsSinceEpoch();
+    PendingRequest request;
+    request.id = m_nextRequestId++;
+    request.method = method.toUpper();
+    request.url = url;
+    request.headers = headers;
+    request.body = body;
+    request.timing.start();
     
-    QString methodUpper = method.toUpper();
+    // The executor holds it back while the host is at the pool's limit
+    request.executorId = m_executor->execute(request.method, request.url, request.headers, request.body,
+                                             m_retryPolicy, request.timing);
+    m_requests.insert(request.id, request);
+    m_executorIds.insert(request.executorId, request.id);
     
-    if (methodUpper == "GET") {
-        m_currentReply = m_networkManager->get(request);
-    } else if (methodUpper == "POST") {
-        m_currentReply = m_networkManager->post(request, requestBody);
-    } else if (methodUpper == "PUT") {
-        m_currentReply = m_networkManager->put(request, requestBody);
-    } else if (methodUpper == "DELETE") {
-        m_currentReply = m_networkManager->deleteResource(request);
-    } else if (methodUpper == "HEAD") {
-        m_currentReply = m_networkManager->head(request);
-    } else if (methodUpper == "PATCH") {
-        m_currentReply = m_networkManager->sendCustomRequest(request, "PATCH", requestBody);
-    } else if (methodUpper == "OPTIONS") {
-        m_currentReply = m_networkManager->sendCustomRequest(request, "OPTIONS");
-    } else {
-        // Default to GET for unknown methods
-        m_currentReply = m_networkManager->get(request);
+    return request.id;
+}
+
+void HttpClient::cancelRequest(int requestId)
+{
+    auto it = m_requests.find(requestId);
+    if (it == m_requests.end()) {
+        return;
     }
     
-    connect(m_currentReply, &QNetworkReply::finished, this, &HttpClient::onReplyFinished);
+    m_executor->abort(it->executorId);
+    releaseRequest(requestId);
+    emit requestCancelled(requestId);
 }
 
-QNetworkRequest HttpClient::createRequest(const QString &url, const QString &headers)
+void HttpClient::cancelAll()
 {
-    QNetworkRequest request;
-    request.setUrl(QUrl(url));
-    
-    // Set default headers
-    request.setHeader(QNetworkRequest::UserAgentHeader, "ApiTester/1.0");
-    request.setRawHeader("Accept", "*/*");
-    
-    // Parse and set custom headers
-    if (!headers.isEmpty()) {
-        QStringList headerLines = headers.split('\n', Qt::SkipEmptyParts);
-        for (const QString &line : headerLines) {
-            int colonIndex = line.indexOf(':');
-            if (colonIndex > 0) {
-                QString headerName = line.left(colonIndex).trimmed();
-                QString headerValue = line.mid(colonIndex + 1).trimmed();
-                request.setRawHeader(headerName.toUtf8(), headerValue.toUtf8());
-            }
-        }
+    const QList<int> ids = m_requests.keys();
+    for (int id : ids) {
+        cancelRequest(id);
     }
-    
-    return request;
 }
 
-void HttpClient::onReplyFinished()
+void HttpClient::releaseRequest(int requestId)
 {
-    if (!m_currentReply) {
+    auto it = m_requests.find(requestId);
+    if (it == m_requests.end()) {
         return;
     }
     
-    qint64 responseTime = QDateTime::currentMSecsSinceEpoch() - m_startTime;
-    int statusCode = m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    
-    // Get response body
-    QByteArray responseData = m_currentReply->readAll();
-    QString response = QString::fromUtf8(responseData);
-    
-    // Get response headers
-    QStringList responseHeaders;
-    const QList<QNetworkReply::RawHeaderPair> headers = m_currentReply->rawHeaderPairs();
-    for (const auto &header : headers) {
-        responseHeaders << QString("%1: %2").arg(QString::fromUtf8(header.first), 
-                                                QString::fromUtf8(header.second));
+    m_executorIds.remove(it->executorId);
+    m_requests.erase(it);
+}
+
+void HttpClient::onExecutorFinished(int executorId, const HttpResponse &response)
+{
+    if (!m_executorIds.contains(executorId)) {
+        return;
     }
-    QString headerString = responseHeaders.join('\n');
     
-    // Handle network errors
-    if (m_currentReply->error() != QNetworkReply::NoError && statusCode == 0) {
-        response = QString("Network Error: %1").arg(m_currentReply->errorString());
-        statusCode = -1;
-    }
+    int requestId = m_executorIds.value(executorId);
+    const PendingRequest pending = m_requests.value(requestId);
     
-    // Save to history
+    // Save to history; a body spilled to disk is saved as its preview,
+    // recorded with the full size so the row is marked truncated
     DatabaseManager::instance().saveToHistory(
-        "GET", // We'll need to pass the actual method later
-        m_currentReply->url().toString(),
-        "", // We'll need to pass the actual request headers later
-        "", // We'll need to pass the actual request body later
-        response,
-        statusCode,
-        responseTime
+        pending.method,
+        pending.url,
+        pending.headers,
+        pending.body,
+        response.isNetworkError() ? QString("Network Error: %1").arg(response.errorString()).toUtf8() : response.body(),
+        response.statusCode(),
+        response.responseTimeMs(),
+        response.timing().toJson(),
+        response.isNetworkError() ? -1 : response.size()
     );
     
-    emit responseReceived(response, statusCode, responseTime, headerString);
-    emit requestFinished();
+    releaseRequest(requestId);
     
-    m_currentReply->deleteLater();
-    m_currentReply = nullptr;
+    emit responseReceived(requestId, response);
+    emit requestFinished(requestId);
 }
\ No newline at end of file
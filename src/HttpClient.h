@@ -2,9 +2,11 @@
 #define HTTPCLIENT_H
 
 #include <QtCore/QObject>
-#include <QtCore/QTimer>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkReply>
+#include <QtCore/QHash>
+#include "RequestTiming.h"
+#include "HttpHeaders.h"
+#include "HttpResponse.h"
+#include "RequestExecutor.h"
 
 class HttpClient : public QObject
 {
@@ -13,24 +15,58 @@ class HttpClient : public QObject
 public:
     explicit HttpClient(QObject *parent = nullptr);
     
-    void sendRequest(const QString &method, const QString &url, 
-                    const QString &headers, const QString &body);
+    // Queues the request and returns its id. Requests run concurrently,
+    // limited per host by NetworkPool::maxConnectionsPerHost().
+    int sendRequest(const QString &method, const QString &url,
+                    const HttpHeaders &headers, const QString &body);
+    void cancelRequest(int requestId);
+    void cancelAll();
+    
+    bool isPending(int requestId) const { return m_requests.contains(requestId); }
+    int pendingRequestCount() const { return m_requests.size(); }
+    
+    // Response bodies larger than this are spilled to a temporary file
+    void setMaxInMemoryBodySize(qint64 maxBytes) { m_executor->setMaxInMemoryBodySize(maxBytes); }
+    qint64 maxInMemoryBodySize() const { return m_executor->maxInMemoryBodySize(); }
+    
+    // Applied to requests sent from now on
+    void setRetryPolicy(const RetryPolicy &policy) { m_retryPolicy = policy; }
+    RetryPolicy retryPolicy() const { return m_retryPolicy; }
     
 signals:
-    void responseReceived(const QString &response, int statusCode, qint64 responseTime, const QString &headers);
-    void requestFinished();
+    // Body data as it arrives, before the request has finished
+    void responseChunk(int requestId, const QByteArray &chunk);
+    void downloadProgress(int requestId, qint64 bytesReceived, qint64 bytesTotal);
+    // The attempt failed and is sent again after backoffMs
+    void requestRetrying(int requestId, int nextAttempt, qint64 backoffMs);
+    // The response carries the timing breakdown; when the body exceeded the
+    // memory limit, response.body() is only a preview (see isSpilled())
+    void responseReceived(int requestId, const HttpResponse &response);
+    void requestCancelled(int requestId);
+    void requestFinished(int requestId);
     
 private slots:
-    void onReplyFinished();
+    void onExecutorFinished(int executorId, const HttpResponse &response);
     
 private:
-    QNetworkRequest createRequest(const QString &url, const QString &headers);
-    QByteArray getMethodVerb(const QString &method);
+    struct PendingRequest
+    {
+        int id;
+        QString method;
+        QString url;
+        HttpHeaders headers;
+        QString body;
+        int executorId;
+        RequestTiming timing;
+    };
+    
+    void releaseRequest(int requestId);
     
-    QNetworkAccessManager *m_networkManager;
-    QNetworkReply *m_currentReply;
-    QTimer m_timer;
-    qint64 m_startTime;
+    RequestExecutor *m_executor;
+    RetryPolicy m_retryPolicy;
+    QHash<int, PendingRequest> m_requests;
+    QHash<int, int> m_executorIds;
+    int m_nextRequestId;
 };
 
 #endif // HTTPCLIENT_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "HttpHeaders.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStringList>
+#include <QtNetwork/QNetworkReply>
+
+static bool sameName(const QByteArray &a, const QByteArray &b)
+{
+    return a.compare(b, Qt::CaseInsensitive) == 0;
+}
+
+void HttpHeaders::append(const QByteArray &name, const QByteArray &value)
+{
+    m_headers.append(qMakePair(name, value));
+}
+
+void HttpHeaders::set(const QByteArray &name, const QByteArray &value)
+{
+    remove(name);
+    append(name, value);
+}
+
+void HttpHeaders::remove(const QByteArray &name)
+{
+    for (int i = m_headers.size() - 1; i >= 0; --i) {
+        if (sameName(m_headers.at(i).first, name)) {
+            m_headers.remove(i);
+        }
+    }
+}
+
+bool HttpHeaders::contains(const QByteArray &name) const
+{
+    for (const Header &header : m_headers) {
+        if (sameName(header.first, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray HttpHeaders::value(const QByteArray &name, const QByteArray &defaultValue) const
+{
+    for (const Header &header : m_headers) {
+        if (sameName(header.first, name)) {
+            return header.second;
+        }
+    }
+    return defaultValue;
+}
+
+void HttpHeaders::applyTo(QNetworkRequest &request) const
+{
+    for (const Header &header : m_headers) {
+        request.setRawHeader(header.first, header.second);
+    }
+}
+
+HttpHeaders HttpHeaders::fromReply(const QNetworkReply *reply)
+{
+    HttpHeaders headers;
+    const QList<QNetworkReply::RawHeaderPair> pairs = reply->rawHeaderPairs();
+    headers.m_headers.reserve(pairs.size());
+    for (const QNetworkReply::RawHeaderPair &pair : pairs) {
+        headers.m_headers.append(pair);
+    }
+    return headers;
+}
+
+QString HttpHeaders::toText() const
+{
+    QStringList lines;
+    for (const Header &header : m_headers) {
+        lines << QString("%1: %2").arg(QString::fromUtf8(header.first), QString::fromUtf8(header.second));
+    }
+    return lines.join('\n');
+}
+
+HttpHeaders HttpHeaders::fromText(const QString &text)
+{
+    HttpHeaders headers;
+    const QStringList lines = text.split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        int colonIndex = line.indexOf(':');
+        if (colonIndex > 0) {
+            headers.append(line.left(colonIndex).trimmed().toUtf8(), line.mid(colonIndex + 1).trimmed().toUtf8());
+        }
+    }
+    return headers;
+}
+
+QString HttpHeaders::toJson() const
+{
+    if (m_headers.isEmpty()) {
+        return QString();
+    }
+    
+    QJsonArray array;
+    for (const Header &header : m_headers) {
+        array.append(QJsonArray({QString::fromUtf8(header.first), QString::fromUtf8(header.second)}));
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+
+HttpHeaders HttpHeaders::fromStored(const QString &stored)
+{
+    if (!stored.startsWith('[')) {
+        return fromText(stored);
+    }
+    
+    HttpHeaders headers;
+    const QJsonArray array = QJsonDocument::fromJson(stored.toUtf8()).array();
+    for (const QJsonValue &value : array) {
+        QJsonArray pair = value.toArray();
+        if (pair.size() == 2 && !pair.at(0).toString().isEmpty()) {
+            headers.append(pair.at(0).toString().toUtf8(), pair.at(1).toString().toUtf8());
+        }
+    }
+    return headers;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef HTTPHEADERS_H
+#define HTTPHEADERS_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <QtCore/QMetaType>
+#include <QtNetwork/QNetworkRequest>
+
+class QNetworkReply;
+
+// An ordered list of header name/value pairs with case-insensitive lookup.
+// Headers are parsed once, where they enter the application, and applied to
+// requests as they are. In the database they are stored as a JSON array of
+// [name, value] pairs.
+class HttpHeaders
+{
+public:
+    typedef QPair<QByteArray, QByteArray> Header;
+    typedef QVector<Header>::const_iterator const_iterator;
+    
+    HttpHeaders() {}
+    
+    void append(const QByteArray &name, const QByteArray &value);
+    // Replaces every header with this name, or appends it
+    void set(const QByteArray &name, const QByteArray &value);
+    void remove(const QByteArray &name);
+    void clear() { m_headers.clear(); }
+    
+    bool contains(const QByteArray &name) const;
+    // The first value for the name
+    QByteArray value(const QByteArray &name, const QByteArray &defaultValue = QByteArray()) const;
+    
+    bool isEmpty() const { return m_headers.isEmpty(); }
+    int size() const { return m_headers.size(); }
+    const Header &at(int index) const { return m_headers.at(index); }
+    const_iterator begin() const { return m_headers.constBegin(); }
+    const_iterator end() const { return m_headers.constEnd(); }
+    
+    // Sets every header on the request; later duplicates win
+    void applyTo(QNetworkRequest &request) const;
+    // The headers a reply received, in arrival order
+    static HttpHeaders fromReply(const QNetworkReply *reply);
+    
+    // "Name: value" lines, as typed by users and shown in the UI
+    QString toText() const;
+    static HttpHeaders fromText(const QString &text);
+    
+    QString toJson() const;
+    // Reads the stored JSON form, or "Name: value" lines written by older versions
+    static HttpHeaders fromStored(const QString &stored);
+    
+    bool operator==(const HttpHeaders &other) const { return m_headers == other.m_headers; }
+    bool operator!=(const HttpHeaders &other) const { return m_headers != other.m_headers; }
+    
+private:
+    QVector<Header> m_headers;
+};
+
+Q_DECLARE_METATYPE(HttpHeaders)
+
+#endif // HTTPHEADERS_H
\ No newline at end of file
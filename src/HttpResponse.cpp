@@ -0,0 +1,117 @@
+#include "HttpResponse.h"
+
+class HttpResponseData : public QSharedData
+{
+public:
+    HttpResponseData() : isNull(true), statusCode(0), networkError(QNetworkReply::NoError) {}
+    
+    bool isNull;
+    int statusCode;
+    ResponseBuffer body;
+    HttpHeaders headers;
+    RequestTiming timing;
+    QString errorString;
+    QNetworkReply::NetworkError networkError;
+    QVector<RequestAttempt> previousAttempts;
+};
+
+HttpResponse::HttpResponse()
+    : d(new HttpResponseData)
+{
+}
+
+HttpResponse::HttpResponse(int statusCode, const ResponseBuffer &body, const HttpHeaders &headers,
+                           const RequestTiming &timing, const QString &errorString,
+                           QNetworkReply::NetworkError networkError)
+    : d(new HttpResponseData)
+{
+    d->isNull = false;
+    d->statusCode = statusCode;
+    d->body = body;
+    d->headers = headers;
+    d->timing = timing;
+    d->errorString = errorString;
+    d->networkError = networkError;
+}
+
+HttpResponse::HttpResponse(const HttpResponse &other) = default;
+HttpResponse &HttpResponse::operator=(const HttpResponse &other) = default;
+HttpResponse::~HttpResponse() = default;
+
+bool HttpResponse::isNull() const
+{
+    return d->isNull;
+}
+
+int HttpResponse::statusCode() const
+{
+    return d->statusCode;
+}
+
+QString HttpResponse::errorString() const
+{
+    return d->errorString;
+}
+
+QNetworkReply::NetworkError HttpResponse::networkError() const
+{
+    return d->networkError;
+}
+
+QByteArray HttpResponse::body() const
+{
+    return d->body.data();
+}
+
+const ResponseBuffer &HttpResponse::bodyBuffer() const
+{
+    return d->body;
+}
+
+qint64 HttpResponse::size() const
+{
+    return d->body.size();
+}
+
+bool HttpResponse::isSpilled() const
+{
+    return d->body.isSpilled();
+}
+
+QString HttpResponse::text() const
+{
+    return QString::fromUtf8(d->body.data());
+}
+
+const HttpHeaders &HttpResponse::headers() const
+{
+    return d->headers;
+}
+
+QByteArray HttpResponse::header(const QByteArray &name) const
+{
+    return d->headers.value(name);
+}
+
+QString HttpResponse::headersText() const
+{
+    return d->headers.toText();
+}
+
+const RequestTiming &HttpResponse::timing() const
+{
+    return d->timing;
+}
+
+QVector<RequestAttempt> HttpResponse::previousAttempts() const
+{
+    return d->previousAttempts;
+}
+
+HttpResponse HttpResponse::withPreviousAttempts(const QVector<RequestAttempt> &attempts) const
+{
+    // Detaching copies the metadata; the body bytes stay shared
+    HttpResponse response(*this);
+    response.d->previousAttempts = attempts;
+    return response;
+}
\ No newline at end of file
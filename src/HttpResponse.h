@@ -0,0 +1,69 @@
+#ifndef HTTPRESPONSE_H
+#define HTTPRESPONSE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QSharedData>
+#include <QtCore/QSharedDataPointer>
+#include <QtCore/QVector>
+#include <QtCore/QMetaType>
+#include <QtNetwork/QNetworkReply>
+#include "HttpHeaders.h"
+#include "RequestTiming.h"
+#include "ResponseBuffer.h"
+#include "RetryPolicy.h"
+
+class HttpResponseData;
+
+// A completed response: status, raw body bytes, headers and timing. It is
+// immutable and implicitly shared, so passing it through signals and keeping
+// it in several places never copies the body. Text is only decoded when a
+// caller asks for it.
+class HttpResponse
+{
+public:
+    HttpResponse();
+    HttpResponse(int statusCode, const ResponseBuffer &body, const HttpHeaders &headers,
+                 const RequestTiming &timing, const QString &errorString = QString(),
+                 QNetworkReply::NetworkError networkError = QNetworkReply::NoError);
+    HttpResponse(const HttpResponse &other);
+    HttpResponse &operator=(const HttpResponse &other);
+    ~HttpResponse();
+    
+    bool isNull() const;
+    
+    // -1 when the request failed before any HTTP status arrived
+    int statusCode() const;
+    bool isNetworkError() const { return statusCode() < 0; }
+    QString errorString() const;
+    QNetworkReply::NetworkError networkError() const;
+    
+    // The whole body, or only its first bytes when it was spilled to disk
+    QByteArray body() const;
+    const ResponseBuffer &bodyBuffer() const;
+    qint64 size() const;
+    bool isSpilled() const;
+    // body() decoded as UTF-8
+    QString text() const;
+    
+    const HttpHeaders &headers() const;
+    QByteArray header(const QByteArray &name) const;
+    // "Name: value" lines
+    QString headersText() const;
+    
+    // Timing of the final attempt only
+    const RequestTiming &timing() const;
+    qint64 responseTimeMs() const { return timing().totalMs(); }
+    
+    // Attempts that were retried before this response, oldest first
+    QVector<RequestAttempt> previousAttempts() const;
+    int attemptCount() const { return previousAttempts().size() + 1; }
+    HttpResponse withPreviousAttempts(const QVector<RequestAttempt> &attempts) const;
+    
+private:
+    QSharedDataPointer<HttpResponseData> d;
+};
+
+Q_DECLARE_METATYPE(HttpResponse)
+
+#endif // HTTPRESPONSE_H
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "JsonTreeModel.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+
+JsonTreeModel::Node::Node(const QString &key, const QJsonValue &value, Node *parent, int row)
+    : label(formatLabel(key, value))
+    , value(value)
+    , parent(parent)
+    , row(row)
+{
+}
+
+JsonTreeModel::Node::~Node()
+{
+    qDeleteAll(children);
+}
+
+int JsonTreeModel::Node::memberCount() const
+{
+    if (value.isObject()) {
+        return value.toObject().size();
+    } else if (value.isArray()) {
+        return value.toArray().size();
+    }
+    return 0;
+}
+
+JsonTreeModel::JsonTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_root(new Node(QString(), QJsonValue(), nullptr, 0))
+{
+}
+
+JsonTreeModel::~JsonTreeModel()
+{
+    delete m_root;
+}
+
+void JsonTreeModel::resetRoot()
+{
+    delete m_root;
+    m_root = new Node(QString(), QJsonValue(), nullptr, 0);
+}
+
+void JsonTreeModel::setDocument(const QJsonDocument &document)
+{
+    beginResetModel();
+    resetRoot();
+    
+    QJsonValue value;
+    if (document.isObject()) {
+        value = document.object();
+    } else if (document.isArray()) {
+        value = document.array();
+    }
+    
+    if (!value.isUndefined()) {
+        m_root->children.append(new Node(QString(), value, m_root, 0));
+    }
+    endResetModel();
+}
+
+void JsonTreeModel::setError(const QString &message)
+{
+    beginResetModel();
+    resetRoot();
+    Node *errorNode = new Node(QString(), QJsonValue(), m_root, 0);
+    errorNode->label = "Invalid JSON: " + message;
+    m_root->children.append(errorNode);
+    endResetModel();
+}
+
+void JsonTreeModel::clear()
+{
+    beginResetModel();
+    resetRoot();
+    endResetModel();
+}
+
+JsonTreeModel::Node *JsonTreeModel::nodeFromIndex(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return m_root;
+    }
+    return static_cast<Node*>(index.internalPointer());
+}
+
+QModelIndex JsonTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Node *parentNode = nodeFromIndex(parent);
+    if (column != 0 || row < 0 || row >= parentNode->children.size()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, parentNode->children.at(row));
+}
+
+QModelIndex JsonTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    
+    Node *parentNode = nodeFromIndex(child)->parent;
+    if (!parentNode || parentNode == m_root) {
+        return QModelIndex();
+    }
+    return createIndex(parentNode->row, 0, parentNode);
+}
+
+int JsonTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+    return nodeFromIndex(parent)->children.size();
+}
+
+int JsonTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool JsonTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    // Report members that have not been fetched yet so the view shows an
+    // expand indicator without building the rows
+    Node *node = nodeFromIndex(parent);
+    if (node == m_root) {
+        return !node->children.isEmpty();
+    }
+    return node->memberCount() > 0;
+}
+
+QVariant JsonTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    
+    Node *node = nodeFromIndex(index);
+    if (role == Qt::DisplayRole) {
+        return node->label;
+    } else if (role == Qt::ToolTipRole && !node->value.isObject() && !node->value.isArray()) {
+        return node->label;
+    }
+    return QVariant();
+}
+
+QVariant JsonTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return "JSON Structure";
+    }
+    return QVariant();
+}
+
+bool JsonTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    Node *node = nodeFromIndex(parent);
+    if (node == m_root) {
+        return false;
+    }
+    return node->children.size() < node->memberCount();
+}
+
+void JsonTreeModel::fetchMore(const QModelIndex &parent)
+{
+    Node *node = nodeFromIndex(parent);
+    if (node == m_root) {
+        return;
+    }
+    
+    int first = node->children.size();
+    int last = qMin(node->memberCount(), first + PageSize) - 1;
+    if (last < first) {
+        return;
+    }
+    
+    beginInsertRows(parent, first, last);
+    node->children.reserve(last + 1);
+    if (node->value.isObject()) {
+        const QJsonObject obj = node->value.toObject();
+        auto it = obj.constBegin() + first;
+        for (int row = first; row <= last; ++row, ++it) {
+            node->children.append(new Node(it.key(), it.value(), node, row));
+        }
+    } else {
+        const QJsonArray array = node->value.toArray();
+        for (int row = first; row <= last; ++row) {
+            node->children.append(new Node(QString("[%1]").arg(row), array.at(row), node, row));
+        }
+    }
+    endInsertRows();
+}
+
+QString JsonTreeModel::formatLabel(const QString &key, const QJsonValue &value)
+{
+    if (value.isObject()) {
+        QString label = QString("Object {%1}").arg(value.toObject().size());
+        return key.isEmpty() ? label : key + " (" + label + ")";
+    } else if (value.isArray()) {
+        QString label = QString("Array [%1]").arg(value.toArray().size());
+        return key.isEmpty() ? label : key + " (" + label + ")";
+    }
+    return key.isEmpty() ? "Value: " + formatScalar(value) : key + ": " + formatScalar(value);
+}
+
+QString JsonTreeModel::formatScalar(const QJsonValue &value)
+{
+    switch (value.type()) {
+        case QJsonValue::String:
+            return "\"" + value.toString() + "\"";
+        case QJsonValue::Double:
+            return QString::number(value.toDouble());
+        case QJsonValue::Bool:
+            return value.toBool() ? "true" : "false";
+        case QJsonValue::Null:
+            return "null";
+        default:
+            return value.toVariant().toString();
+    }
+}
\ No newline at end of file
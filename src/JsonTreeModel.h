@@ -0,0 +1,63 @@
+#ifndef JSONTREEMODEL_H
+#define JSONTREEMODEL_H
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonValue>
+#include <QtCore/QVector>
+
+// Tree model over a parsed JSON document. Child rows are only created when a
+// node is expanded, and arrays and objects with many members are exposed in
+// pages of PageSize rows that the view fetches as it scrolls.
+class JsonTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+    
+public:
+    static const int PageSize = 500;
+    
+    explicit JsonTreeModel(QObject *parent = nullptr);
+    ~JsonTreeModel();
+    
+    void setDocument(const QJsonDocument &document);
+    // Replaces the tree with a single row describing why parsing failed
+    void setError(const QString &message);
+    void clear();
+    
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    
+private:
+    struct Node
+    {
+        Node(const QString &key, const QJsonValue &value, Node *parent, int row);
+        ~Node();
+        
+        // Number of members in the underlying object or array
+        int memberCount() const;
+        
+        QString label;
+        QJsonValue value;
+        Node *parent;
+        int row;
+        QVector<Node*> children;
+    };
+    
+    Node *nodeFromIndex(const QModelIndex &index) const;
+    void resetRoot();
+    static QString formatLabel(const QString &key, const QJsonValue &value);
+    static QString formatScalar(const QJsonValue &value);
+    
+    // Invisible root; its single child is the document itself
+    Node *m_root;
+};
+
+#endif // JSONTREEMODEL_H
\ No newline at end of file
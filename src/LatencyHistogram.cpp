@@ -0,0 +1,130 @@
+#include "LatencyHistogram.h"
+#include <QtCore/qalgorithms.h>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 2048 linear sub-buckets per power of two gives three significant digits
+const int SubBucketCountMagnitude = 11;
+}
+
+LatencyHistogram::LatencyHistogram(qint64 highestTrackableValue)
+    : m_highestTrackableValue(qMax<qint64>(highestTrackableValue, 2))
+    , m_subBucketHalfCountMagnitude(SubBucketCountMagnitude - 1)
+    , m_subBucketHalfCount(1 << (SubBucketCountMagnitude - 1))
+    , m_subBucketMask((qint64(1) << SubBucketCountMagnitude) - 1)
+    , m_totalCount(0)
+    , m_minValue(std::numeric_limits<qint64>::max())
+    , m_maxValue(0)
+    , m_sum(0.0)
+{
+    // Each bucket covers the next power of two at the same relative precision
+    qint64 smallestUntrackableValue = qint64(1) << SubBucketCountMagnitude;
+    int bucketsNeeded = 1;
+    while (smallestUntrackableValue <= m_highestTrackableValue) {
+        if (smallestUntrackableValue > std::numeric_limits<qint64>::max() / 2) {
+            bucketsNeeded++;
+            break;
+        }
+        smallestUntrackableValue <<= 1;
+        bucketsNeeded++;
+    }
+    
+    m_counts.fill(0, (bucketsNeeded + 1) * m_subBucketHalfCount);
+}
+
+void LatencyHistogram::recordValue(qint64 value)
+{
+    value = qBound<qint64>(0, value, m_highestTrackableValue);
+    
+    m_counts[countsIndexFor(value)]++;
+    m_totalCount++;
+    m_minValue = qMin(m_minValue, value);
+    m_maxValue = qMax(m_maxValue, value);
+    m_sum += double(value);
+}
+
+void LatencyHistogram::add(const LatencyHistogram &other)
+{
+    if (other.m_counts.size() == m_counts.size()) {
+        for (int i = 0; i < m_counts.size(); ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+    } else {
+        // Differently sized histograms are merged value by value
+        for (int i = 0; i < other.m_counts.size(); ++i) {
+            qint64 count = other.m_counts[i];
+            if (count > 0) {
+                int index = countsIndexFor(qMin(other.valueFromIndex(i), m_highestTrackableValue));
+                m_counts[index] += count;
+            }
+        }
+    }
+    
+    if (other.m_totalCount > 0) {
+        m_minValue = qMin(m_minValue, other.m_minValue);
+        m_maxValue = qMax(m_maxValue, qMin(other.m_maxValue, m_highestTrackableValue));
+    }
+    m_totalCount += other.m_totalCount;
+    m_sum += other.m_sum;
+}
+
+void LatencyHistogram::reset()
+{
+    m_counts.fill(0);
+    m_totalCount = 0;
+    m_minValue = std::numeric_limits<qint64>::max();
+    m_maxValue = 0;
+    m_sum = 0.0;
+}
+
+double LatencyHistogram::mean() const
+{
+    return m_totalCount > 0 ? m_sum / double(m_totalCount) : 0.0;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    
+    percentile = qBound(0.0, percentile, 100.0);
+    qint64 countAtPercentile = qint64(std::ceil(percentile / 100.0 * double(m_totalCount)));
+    countAtPercentile = qMax<qint64>(1, countAtPercentile);
+    
+    qint64 runningCount = 0;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        runningCount += m_counts[i];
+        if (runningCount >= countAtPercentile) {
+            return qMin(highestEquivalentValue(i), m_maxValue);
+        }
+    }
+    
+    return m_maxValue;
+}
+
+int LatencyHistogram::countsIndexFor(qint64 value) const
+{
+    int pow2Ceiling = 64 - qCountLeadingZeroBits(quint64(value | m_subBucketMask));
+    int bucketIndex = pow2Ceiling - m_subBucketHalfCountMagnitude - 1;
+    int subBucketIndex = int(value >> bucketIndex);
+    return ((bucketIndex + 1) << m_subBucketHalfCountMagnitude) + (subBucketIndex - m_subBucketHalfCount);
+}
+
+qint64 LatencyHistogram::valueFromIndex(int index) const
+{
+    int bucketIndex = (index >> m_subBucketHalfCountMagnitude) - 1;
+    int subBucketIndex = (index & (m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+    if (bucketIndex < 0) {
+        subBucketIndex -= m_subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return qint64(subBucketIndex) << bucketIndex;
+}
+
+qint64 LatencyHistogram::highestEquivalentValue(int index) const
+{
+    int bucketIndex = qMax(0, (index >> m_subBucketHalfCountMagnitude) - 1);
+    return valueFromIndex(index) + (qint64(1) << bucketIndex) - 1;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+
+// Log-linear histogram in the style of HdrHistogram. Values are recorded in
+// microseconds with three significant digits of precision, so every sample
+// can be kept without storing the samples themselves.
+class LatencyHistogram
+{
+public:
+    explicit LatencyHistogram(qint64 highestTrackableValue = 3600LL * 1000 * 1000);
+    
+    void recordValue(qint64 value);
+    void add(const LatencyHistogram &other);
+    void reset();
+    
+    qint64 totalCount() const { return m_totalCount; }
+    qint64 minValue() const { return m_totalCount > 0 ? m_minValue : 0; }
+    qint64 maxValue() const { return m_maxValue; }
+    double mean() const;
+    
+    // Highest value at or below which the given percentage (0-100) of samples fall
+    qint64 valueAtPercentile(double percentile) const;
+    
+private:
+    int countsIndexFor(qint64 value) const;
+    qint64 valueFromIndex(int index) const;
+    qint64 highestEquivalentValue(int index) const;
+    
+    qint64 m_highestTrackableValue;
+    int m_subBucketHalfCountMagnitude;
+    int m_subBucketHalfCount;
+    qint64 m_subBucketMask;
+    QVector<qint64> m_counts;
+    qint64 m_totalCount;
+    qint64 m_minValue;
+    qint64 m_maxValue;
+    double m_sum;
+};
+
+#endif // LATENCYHISTOGRAM_H
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "LoadTester.h"
+
+namespace {
+const qint64 NanosecondsPerSecond = 1000LL * 1000 * 1000;
+const qint64 ProgressIntervalNs = 250LL * 1000 * 1000;
+}
+
+double LoadTestReport::throughput() const
+{
+    return elapsedMs > 0 ? completedRequests * 1000.0 / double(elapsedMs) : 0.0;
+}
+
+double LoadTestReport::errorRate() const
+{
+    qint64 total = completedRequests + timedOutRequests;
+    return total > 0 ? double(errorCount) / double(total) : 0.0;
+}
+
+QString LoadTestReport::toText() const
+{
+    auto ms = [](qint64 micros) { return QString::number(micros / 1000.0, 'f', 2); };
+    
+    QString text;
+    text += QString("Target rate: %1 req/s\n").arg(targetRate, 0, 'f', 1);
+    text += QString("Requests: %1 scheduled, %2 completed, %3 timed out\n")
+            .arg(scheduledRequests).arg(completedRequests).arg(timedOutRequests);
+    text += QString("Duration: %1 s\n").arg(elapsedMs / 1000.0, 0, 'f', 2);
+    text += QString("Throughput: %1 req/s\n").arg(throughput(), 0, 'f', 1);
+    text += QString("Error rate: %1% (%2 errors)\n").arg(errorRate() * 100.0, 0, 'f', 2).arg(errorCount);
+    text += QString("\nLatency (ms, from scheduled send time):\n");
+    text += QString("  p50: %1  p90: %2  p99: %3  p99.9: %4\n")
+            .arg(ms(latency.valueAtPercentile(50.0)), ms(latency.valueAtPercentile(90.0)),
+                 ms(latency.valueAtPercentile(99.0)), ms(latency.valueAtPercentile(99.9)));
+    text += QString("  min: %1  mean: %2  max: %3\n")
+            .arg(ms(latency.minValue()), ms(qint64(latency.mean())), ms(latency.maxValue()));
+    text += QString("\nService time (ms, from actual send):\n");
+    text += QString("  p50: %1  p99: %2  max: %3\n")
+            .arg(ms(serviceTime.valueAtPercentile(50.0)), ms(serviceTime.valueAtPercentile(99.0)),
+                 ms(serviceTime.maxValue()));
+    return text;
+}
+
+LoadTester::LoadTester(QObject *parent)
+    : QObject(parent)
+    , m_executor(new RequestExecutor(this))
+    , m_durationNs(0)
+    , m_nextArrival(0)
+    , m_lastProgressNs(0)
+    , m_isRunning(false)
+{
+    // A coarse timer would bunch arrivals together and distort the schedule
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    m_tickTimer.setInterval(1);
+    connect(&m_tickTimer, &QTimer::timeout, this, &LoadTester::onTick);
+    
+    m_drainTimer.setSingleShot(true);
+    connect(&m_drainTimer, &QTimer::timeout, this, &LoadTester::onDrainTimeout);
+    
+    connect(m_executor, &RequestExecutor::finished, this, &LoadTester::onRequestFinished);
+}
+
+void LoadTester::start(const LoadTestOptions &options)
+{
+    if (m_isRunning || m_tests.isEmpty() || options.requestsPerSecond <= 0.0
+        || options.durationSeconds <= 0) {
+        return;
+    }
+    
+    m_options = options;
+    m_report = LoadTestReport();
+    m_report.targetRate = options.requestsPerSecond;
+    m_durationNs = qint64(options.durationSeconds) * NanosecondsPerSecond;
+    m_nextArrival = 0;
+    m_lastProgressNs = 0;
+    m_isRunning = true;
+    
+    m_clock.start();
+    m_tickTimer.start();
+    onTick();
+}
+
+void LoadTester::stop()
+{
+    if (!m_isRunning) {
+        return;
+    }
+    
+    m_tickTimer.stop();
+    onDrainTimeout();
+}
+
+qint64 LoadTester::arrivalTimeNs(qint64 arrivalIndex) const
+{
+    // Computed from the index rather than accumulated to avoid drift
+    return qint64(double(arrivalIndex) * double(NanosecondsPerSecond) / m_options.requestsPerSecond);
+}
+
+void LoadTester::onTick()
+{
+    qint64 now = m_clock.nsecsElapsed();
+    
+    // Send every request whose scheduled time has passed, even if the
+    // previous ones have not completed yet
+    qint64 scheduledNs = arrivalTimeNs(m_nextArrival);
+    while (scheduledNs <= now && scheduledNs < m_durationNs) {
+        sendScheduledRequest(scheduledNs);
+        scheduledNs = arrivalTimeNs(++m_nextArrival);
+    }
+    
+    if (now - m_lastProgressNs >= ProgressIntervalNs) {
+        m_lastProgressNs = now;
+        emit progress(m_report.scheduledRequests, m_report.completedRequests, m_report.errorCount);
+    }
+    
+    if (scheduledNs >= m_durationNs) {
+        m_tickTimer.stop();
+        if (m_inFlight.isEmpty()) {
+            finish();
+        } else {
+            m_drainTimer.start(m_options.drainTimeoutSeconds * 1000);
+        }
+    }
+}
+
+void LoadTester::sendScheduledRequest(qint64 scheduledNs)
+{
+    int testIndex = int(m_report.scheduledRequests % m_tests.size());
+    
+    InFlightRequest request;
+    request.testIndex = testIndex;
+    request.scheduledNs = scheduledNs;
+    request.sentNs = m_clock.nsecsElapsed();
+    
+    int requestId = TestRunner::sendTestRequest(m_executor, m_tests.at(testIndex));
+    m_inFlight.insert(requestId, request);
+    m_report.scheduledRequests++;
+}
+
+void LoadTester::onRequestFinished(int requestId, const HttpResponse &response)
+{
+    if (!m_inFlight.contains(requestId)) {
+        return;
+    }
+    
+    qint64 now = m_clock.nsecsElapsed();
+    InFlightRequest request = m_inFlight.take(requestId);
+    
+    m_report.latency.recordValue((now - request.scheduledNs) / 1000);
+    // Waiting for one of the pool's per-host slots is queueing, not service
+    qint64 queuedNs = qMax<qint64>(0, response.timing().queuedNs());
+    m_report.serviceTime.recordValue((now - request.sentNs - queuedNs) / 1000);
+    m_report.completedRequests++;
+    
+    int statusCode = response.statusCode();
+    const TestCase &testCase = m_tests.at(request.testIndex);
+    
+    bool failed = false;
+    if (response.isNetworkError()) {
+        failed = true;
+    } else if (!testCase.expectedStatusCode.isEmpty()) {
+        failed = testCase.expectedStatusCode != QString::number(statusCode);
+    } else {
+        failed = statusCode >= 400;
+    }
+    if (failed) {
+        m_report.errorCount++;
+    }
+    
+    if (!m_tickTimer.isActive() && m_inFlight.isEmpty()) {
+        finish();
+    }
+}
+
+void LoadTester::onDrainTimeout()
+{
+    // Replies still outstanding count as errors
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end(); ++it) {
+        m_executor->abort(it.key());
+        m_report.timedOutRequests++;
+        m_report.errorCount++;
+    }
+    m_inFlight.clear();
+    
+    finish();
+}
+
+void LoadTester::finish()
+{
+    if (!m_isRunning) {
+        return;
+    }
+    
+    m_drainTimer.stop();
+    m_tickTimer.stop();
+    m_isRunning = false;
+    m_report.elapsedMs = m_clock.elapsed();
+    
+    emit progress(m_report.scheduledRequests, m_report.completedRequests, m_report.errorCount);
+    emit finished(m_report);
+}
\ No newline at end of file
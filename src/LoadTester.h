@@ -0,0 +1,99 @@
+#ifndef LOADTESTER_H
+#define LOADTESTER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include "TestRunner.h"
+#include "RequestExecutor.h"
+#include "LatencyHistogram.h"
+
+struct LoadTestOptions
+{
+    LoadTestOptions() : requestsPerSecond(10.0), durationSeconds(10), drainTimeoutSeconds(30) {}
+    
+    double requestsPerSecond;
+    int durationSeconds;
+    // How long to wait for outstanding replies once the schedule has ended
+    int drainTimeoutSeconds;
+};
+
+struct LoadTestReport
+{
+    LoadTestReport()
+        : targetRate(0.0), scheduledRequests(0), completedRequests(0)
+        , errorCount(0), timedOutRequests(0), elapsedMs(0) {}
+    
+    double throughput() const;
+    double errorRate() const;
+    QString toText() const;
+    
+    double targetRate;
+    qint64 scheduledRequests;
+    qint64 completedRequests;
+    qint64 errorCount;
+    qint64 timedOutRequests;
+    qint64 elapsedMs;
+    // Measured from the scheduled send time, so queueing delay is included
+    LatencyHistogram latency;
+    // Measured from the moment the request was actually dispatched
+    LatencyHistogram serviceTime;
+};
+
+// Open-loop load generator: requests are sent on a fixed schedule derived
+// from the target rate, independent of how quickly earlier ones complete.
+class LoadTester : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit LoadTester(QObject *parent = nullptr);
+    
+    // Requests are taken from the list in round-robin order
+    void setTests(const QList<TestCase> &tests) { m_tests = tests; }
+    QList<TestCase> tests() const { return m_tests; }
+    
+    void start(const LoadTestOptions &options);
+    void stop();
+    bool isRunning() const { return m_isRunning; }
+    
+    const LoadTestReport &report() const { return m_report; }
+    
+signals:
+    void progress(qint64 sentRequests, qint64 completedRequests, qint64 errorCount);
+    void finished(const LoadTestReport &report);
+    
+private slots:
+    void onTick();
+    void onRequestFinished(int requestId, const HttpResponse &response);
+    void onDrainTimeout();
+    
+private:
+    struct InFlightRequest
+    {
+        int testIndex;
+        qint64 scheduledNs;
+        qint64 sentNs;
+    };
+    
+    qint64 arrivalTimeNs(qint64 arrivalIndex) const;
+    void sendScheduledRequest(qint64 scheduledNs);
+    void finish();
+    
+    QList<TestCase> m_tests;
+    RequestExecutor *m_executor;
+    // Keyed by executor request id
+    QHash<int, InFlightRequest> m_inFlight;
+    QTimer m_tickTimer;
+    QTimer m_drainTimer;
+    QElapsedTimer m_clock;
+    LoadTestOptions m_options;
+    LoadTestReport m_report;
+    qint64 m_durationNs;
+    qint64 m_nextArrival;
+    qint64 m_lastProgressNs;
+    bool m_isRunning;
+};
+
+#endif // LOADTESTER_H
\ No newline at end of file
@@ -198,10 +198,22 @@ void MainWindow::createNewRequestTab()
     RequestPanel *requestPanel = new RequestPanel(this);
     
     // Connect request panel to response panel
+    connect(requestPanel, &RequestPanel::requestStarted, m_responsePanel, &ResponsePanel::beginResponse);
+    connect(requestPanel, &RequestPanel::responseChunk, m_responsePanel, &ResponsePanel::appendBodyChunk);
     connect(requestPanel, &RequestPanel::responseReceived, m_responsePanel, &ResponsePanel::displayResponse);
+    connect(requestPanel, &RequestPanel::downloadProgress, [this](qint64 received, qint64 total) {
+        if (total > 0) {
+            statusBar()->showMessage(QString("Receiving response... %1 of %2 KB").arg(received / 1024).arg(total / 1024));
+        } else {
+            statusBar()->showMessage(QString("Receiving response... %1 KB").arg(received / 1024));
+        }
+    });
     connect(requestPanel, &RequestPanel::requestStarted, [this]() {
         statusBar()->showMessage("Sending request...");
     });
+    connect(requestPanel, &RequestPanel::requestRetrying, [this](int nextAttempt, qint64 backoffMs) {
+        statusBar()->showMessage(QString("Request failed, sending attempt %1 in %2 ms...").arg(nextAttempt).arg(backoffMs));
+    });
     connect(requestPanel, &RequestPanel::requestFinished, [this]() {
         statusBar()->showMessage("Request completed");
     });
@@ -209,7 +221,7 @@ void MainWindow::createNewRequestTab()
     // Connect collection manager to request panel for loading saved requests
     connect(m_collectionManager, &CollectionManager::requestSelected,
             [requestPanel](const QString &name, const QString &method, const QString &url,
-                          const QString &headers, const QString &body, const QString &parameters) {
+                          const HttpHeaders &headers, const QString &body, const QString &parameters) {
         requestPanel->setMethod(method);
         requestPanel->setUrl(url);
         requestPanel->setHeaders(headers);
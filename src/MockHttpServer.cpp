@@ -0,0 +1,379 @@
+#include "MockHttpServer.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QDebug>
+
+namespace {
+const int MaxHeaderSize = 64 * 1024;
+const qint64 MaxBodySize = 64 * 1024 * 1024;
+const int DripIntervalMs = 100;
+}
+
+MockHttpServer::MockHttpServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_random(1)
+    , m_requestCount(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MockHttpServer::onNewConnection);
+}
+
+bool MockHttpServer::listen(const QHostAddress &address, quint16 port)
+{
+    if (!m_server->listen(address, port)) {
+        qWarning() << "Mock server failed to listen:" << m_server->errorString();
+        return false;
+    }
+    return true;
+}
+
+void MockHttpServer::close()
+{
+    m_server->close();
+    
+    const QList<QTcpSocket*> sockets = m_clients.keys();
+    for (QTcpSocket *socket : sockets) {
+        socket->abort();
+    }
+}
+
+QString MockHttpServer::baseUrl() const
+{
+    QHostAddress address = m_server->serverAddress();
+    QString host = address == QHostAddress::Any || address == QHostAddress::AnyIPv4
+        ? QString("127.0.0.1") : address.toString();
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        host = address == QHostAddress::AnyIPv6 ? QString("[::1]") : QString("[%1]").arg(host);
+    }
+    return QString("http://%1:%2").arg(host).arg(m_server->serverPort());
+}
+
+void MockHttpServer::addRoute(const MockRoute &route)
+{
+    m_routes.append(route);
+}
+
+QList<MockRoute> MockHttpServer::routesFromJson(const QJsonArray &array)
+{
+    QList<MockRoute> routes;
+    for (const QJsonValue &value : array) {
+        QJsonObject obj = value.toObject();
+        MockRoute route;
+        route.method = obj.value("method").toString().toUpper();
+        route.path = obj.value("path").toString("*");
+        route.statusCode = obj.value("statusCode").toInt(route.statusCode);
+        route.contentType = obj.value("contentType").toString(QString::fromLatin1(route.contentType)).toLatin1();
+        route.echo = obj.value("echo").toBool();
+        route.latencyMs = obj.value("latencyMs").toInt();
+        route.jitterMs = obj.value("jitterMs").toInt();
+        route.chunkSize = obj.value("chunkSize").toInt();
+        route.dripBytesPerSecond = obj.value("dripBytesPerSecond").toInt();
+        route.errorRate = obj.value("errorRate").toDouble();
+        route.errorStatusCode = obj.value("errorStatusCode").toInt(route.errorStatusCode);
+        
+        QJsonValue body = obj.value("body");
+        if (body.isString()) {
+            route.body = body.toString().toUtf8();
+        } else if (body.isObject()) {
+            route.body = QJsonDocument(body.toObject()).toJson(QJsonDocument::Compact);
+        } else if (body.isArray()) {
+            route.body = QJsonDocument(body.toArray()).toJson(QJsonDocument::Compact);
+        } else if (obj.contains("bodySize")) {
+            route.body = QByteArray(obj.value("bodySize").toInt(), 'x');
+        }
+        
+        const QJsonObject headers = obj.value("headers").toObject();
+        for (auto it = headers.begin(); it != headers.end(); ++it) {
+            route.headers.append(qMakePair(it.key().toLatin1(), it.value().toString().toLatin1()));
+        }
+        
+        routes.append(route);
+    }
+    return routes;
+}
+
+void MockHttpServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, Client());
+        connect(socket, &QTcpSocket::readyRead, this, &MockHttpServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &MockHttpServer::onDisconnected);
+    }
+}
+
+void MockHttpServer::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    
+    m_clients.remove(socket);
+    socket->deleteLater();
+}
+
+void MockHttpServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_clients.contains(socket)) {
+        return;
+    }
+    
+    m_clients[socket].buffer.append(socket->readAll());
+    processBuffer(socket);
+}
+
+bool MockHttpServer::takeRequest(QByteArray &buffer, Request *request, bool *malformed)
+{
+    *malformed = false;
+    
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        *malformed = buffer.size() > MaxHeaderSize;
+        return false;
+    }
+    
+    QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.")) {
+        *malformed = true;
+        return false;
+    }
+    
+    request->method = QString::fromLatin1(requestLine.at(0)).toUpper();
+    QByteArray target = requestLine.at(1);
+    int queryIndex = target.indexOf('?');
+    request->path = QString::fromUtf8(queryIndex < 0 ? target : target.left(queryIndex));
+    
+    request->headers.clear();
+    for (int i = 1; i < lines.size(); ++i) {
+        int colonIndex = lines.at(i).indexOf(':');
+        if (colonIndex > 0) {
+            request->headers.insert(lines.at(i).left(colonIndex).trimmed().toLower(),
+                                    lines.at(i).mid(colonIndex + 1).trimmed());
+        }
+    }
+    
+    qint64 contentLength = request->headers.value("content-length").toLongLong();
+    if (contentLength < 0 || contentLength > MaxBodySize) {
+        *malformed = true;
+        return false;
+    }
+    
+    int bodyStart = headerEnd + 4;
+    if (buffer.size() - bodyStart < contentLength) {
+        return false;
+    }
+    
+    request->body = buffer.mid(bodyStart, int(contentLength));
+    buffer.remove(0, bodyStart + int(contentLength));
+    
+    // HTTP/1.1 keeps the connection open unless asked not to; 1.0 the reverse
+    QByteArray connection = request->headers.value("connection").toLower();
+    request->keepAlive = requestLine.at(2) == "HTTP/1.0" ? connection == "keep-alive" : connection != "close";
+    return true;
+}
+
+const MockRoute *MockHttpServer::findRoute(const Request &request) const
+{
+    for (const MockRoute &route : m_routes) {
+        if (!route.method.isEmpty() && route.method != "*" && route.method != request.method) {
+            continue;
+        }
+        
+        bool matches = route.path.endsWith('*')
+            ? request.path.startsWith(route.path.left(route.path.size() - 1))
+            : request.path == route.path;
+        if (matches) {
+            return &route;
+        }
+    }
+    return nullptr;
+}
+
+void MockHttpServer::processBuffer(QTcpSocket *socket)
+{
+    Client &client = m_clients[socket];
+    if (client.busy) {
+        return;
+    }
+    
+    Request request;
+    bool malformed = false;
+    if (!takeRequest(client.buffer, &request, &malformed)) {
+        if (malformed) {
+            MockRoute badRequest;
+            badRequest.statusCode = 400;
+            badRequest.contentType = "text/plain";
+            badRequest.body = "Malformed request";
+            request.keepAlive = false;
+            client.buffer.clear();
+            client.busy = true;
+            respond(socket, badRequest, request);
+        }
+        return;
+    }
+    
+    ++m_requestCount;
+    client.busy = true;
+    
+    MockRoute route;
+    if (const MockRoute *match = findRoute(request)) {
+        route = *match;
+    } else {
+        route.statusCode = 404;
+        route.contentType = "text/plain";
+        route.body = QString("No mock route for %1 %2").arg(request.method, request.path).toUtf8();
+    }
+    
+    int delayMs = route.latencyMs;
+    if (route.jitterMs > 0) {
+        delayMs += m_random.bounded(-route.jitterMs, route.jitterMs + 1);
+    }
+    
+    if (delayMs <= 0) {
+        respond(socket, route, request);
+        return;
+    }
+    
+    // The socket is the context, so the timer is dropped if the client goes away
+    QTimer::singleShot(delayMs, socket, [this, socket, route, request]() {
+        respond(socket, route, request);
+    });
+}
+
+void MockHttpServer::respond(QTcpSocket *socket, const MockRoute &route, const Request &request)
+{
+    if (!m_clients.contains(socket)) {
+        return;
+    }
+    
+    int statusCode = route.statusCode;
+    QByteArray contentType = route.contentType;
+    QByteArray body = route.echo ? request.body : route.body;
+    bool chunked = route.chunkSize > 0;
+    bool dripping = route.dripBytesPerSecond > 0;
+    
+    if (route.errorRate > 0.0 && m_random.generateDouble() < route.errorRate) {
+        statusCode = route.errorStatusCode;
+        contentType = "text/plain";
+        body = "Injected error";
+        chunked = false;
+        dripping = false;
+    }
+    
+    emit requestReceived(request.method, request.path, statusCode);
+    
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(statusCode) + ' ' + reasonPhrase(statusCode) + "\r\n";
+    if (!contentType.isEmpty()) {
+        head += "Content-Type: " + contentType + "\r\n";
+    }
+    head += chunked ? QByteArray("Transfer-Encoding: chunked\r\n")
+                    : "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    head += request.keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    for (const auto &header : route.headers) {
+        head += header.first + ": " + header.second + "\r\n";
+    }
+    head += "\r\n";
+    socket->write(head);
+    
+    Client &client = m_clients[socket];
+    client.remaining = request.method == "HEAD" ? QByteArray() : body;
+    client.chunked = chunked;
+    client.keepAlive = request.keepAlive;
+    
+    if (dripping) {
+        client.pieceSize = qMax(1, route.dripBytesPerSecond * DripIntervalMs / 1000);
+        if (chunked) {
+            client.pieceSize = qMin(client.pieceSize, route.chunkSize);
+        }
+        if (!client.dripTimer) {
+            client.dripTimer = new QTimer(socket);
+            client.dripTimer->setInterval(DripIntervalMs);
+            connect(client.dripTimer, &QTimer::timeout, this, [this, socket]() {
+                writeNextPiece(socket);
+            });
+        }
+        client.dripTimer->start();
+        return;
+    }
+    
+    client.pieceSize = chunked ? route.chunkSize : client.remaining.size();
+    while (m_clients.contains(socket) && m_clients[socket].busy) {
+        writeNextPiece(socket);
+    }
+}
+
+void MockHttpServer::writeNextPiece(QTcpSocket *socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    
+    Client &client = it.value();
+    if (!client.remaining.isEmpty()) {
+        QByteArray piece = client.remaining.left(qMax(1, client.pieceSize));
+        client.remaining.remove(0, piece.size());
+        if (client.chunked) {
+            socket->write(QByteArray::number(piece.size(), 16) + "\r\n" + piece + "\r\n");
+        } else {
+            socket->write(piece);
+        }
+    }
+    
+    if (client.remaining.isEmpty()) {
+        if (client.chunked) {
+            socket->write("0\r\n\r\n");
+        }
+        finishResponse(socket);
+    }
+}
+
+void MockHttpServer::finishResponse(QTcpSocket *socket)
+{
+    Client &client = m_clients[socket];
+    client.busy = false;
+    if (client.dripTimer) {
+        client.dripTimer->stop();
+    }
+    
+    if (!client.keepAlive) {
+        m_clients.remove(socket);
+        socket->disconnectFromHost();
+        return;
+    }
+    
+    // Pipelined requests may already be waiting
+    if (!client.buffer.isEmpty()) {
+        QTimer::singleShot(0, socket, [this, socket]() {
+            if (m_clients.contains(socket)) {
+                processBuffer(socket);
+            }
+        });
+    }
+}
+
+QByteArray MockHttpServer::reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 408: return "Request Timeout";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Status";
+    }
+}
\ No newline at end of file
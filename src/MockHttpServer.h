@@ -0,0 +1,124 @@
+#ifndef MOCKHTTPSERVER_H
+#define MOCKHTTPSERVER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTimer>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+// A canned response and the faults to inject while serving it
+struct MockRoute
+{
+    MockRoute()
+        : statusCode(200), contentType("application/json"), echo(false), latencyMs(0), jitterMs(0)
+        , chunkSize(0), dripBytesPerSecond(0), errorRate(0.0), errorStatusCode(500) {}
+    
+    // Empty or "*" matches any method
+    QString method;
+    // Exact path, or a prefix when it ends with '*'; the query string is ignored
+    QString path;
+    int statusCode;
+    QByteArray contentType;
+    QByteArray body;
+    QList<QPair<QByteArray, QByteArray>> headers;
+    // Respond with the request body instead of body
+    bool echo;
+    // Delay before the response starts, plus or minus up to jitterMs
+    int latencyMs;
+    int jitterMs;
+    // Above 0, the body is sent with chunked transfer encoding in pieces of this size
+    int chunkSize;
+    // Above 0, the body is trickled out at this rate after the headers
+    int dripBytesPerSecond;
+    // Fraction of requests answered with errorStatusCode instead
+    double errorRate;
+    int errorStatusCode;
+};
+
+// Minimal HTTP/1.1 server for exercising the client, the test runner and the
+// load tester on localhost without a real backend. Connections are kept
+// alive, pipelined requests are answered in order, and the random source for
+// jitter and error injection is seeded so runs are reproducible.
+class MockHttpServer : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit MockHttpServer(QObject *parent = nullptr);
+    
+    // Port 0 picks a free port; see serverPort()
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    void close();
+    bool isListening() const { return m_server->isListening(); }
+    quint16 serverPort() const { return m_server->serverPort(); }
+    QString baseUrl() const;
+    QString errorString() const { return m_server->errorString(); }
+    
+    // Routes are matched in the order they were added
+    void addRoute(const MockRoute &route);
+    void setRoutes(const QList<MockRoute> &routes) { m_routes = routes; }
+    QList<MockRoute> routes() const { return m_routes; }
+    void clearRoutes() { m_routes.clear(); }
+    
+    void setSeed(quint32 seed) { m_random.seed(seed); }
+    qint64 requestCount() const { return m_requestCount; }
+    
+    // Reads routes from a JSON array of objects using the MockRoute field
+    // names; "body" may be a string or any JSON value, and "bodySize"
+    // generates a filler body of that many bytes
+    static QList<MockRoute> routesFromJson(const QJsonArray &array);
+    
+signals:
+    void requestReceived(const QString &method, const QString &path, int statusCode);
+    
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    
+private:
+    struct Request
+    {
+        QString method;
+        QString path;
+        QHash<QByteArray, QByteArray> headers;
+        QByteArray body;
+        bool keepAlive;
+    };
+    
+    struct Client
+    {
+        Client() : busy(false), chunked(false), keepAlive(true), pieceSize(0), dripTimer(nullptr) {}
+        
+        QByteArray buffer;
+        // A response is being delayed or written; later requests wait
+        bool busy;
+        // Remaining body of the response being written
+        QByteArray remaining;
+        bool chunked;
+        bool keepAlive;
+        int pieceSize;
+        QTimer *dripTimer;
+    };
+    
+    static bool takeRequest(QByteArray &buffer, Request *request, bool *malformed);
+    static QByteArray reasonPhrase(int statusCode);
+    const MockRoute *findRoute(const Request &request) const;
+    void processBuffer(QTcpSocket *socket);
+    void respond(QTcpSocket *socket, const MockRoute &route, const Request &request);
+    void writeNextPiece(QTcpSocket *socket);
+    void finishResponse(QTcpSocket *socket);
+    
+    QTcpServer *m_server;
+    QHash<QTcpSocket*, Client> m_clients;
+    QList<MockRoute> m_routes;
+    QRandomGenerator m_random;
+    qint64 m_requestCount;
+};
+
+#endif // MOCKHTTPSERVER_H
\ No newline at end of file
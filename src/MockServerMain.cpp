@@ -0,0 +1,114 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include "MockHttpServer.h"
+#include <cstdio>
+
+namespace {
+// Served when no routes file is given
+QList<MockRoute> defaultRoutes()
+{
+    QList<MockRoute> routes;
+    
+    MockRoute echo;
+    echo.path = "/echo";
+    echo.echo = true;
+    routes.append(echo);
+    
+    MockRoute slow;
+    slow.path = "/slow";
+    slow.latencyMs = 500;
+    slow.jitterMs = 100;
+    slow.body = "{\"slow\": true}";
+    routes.append(slow);
+    
+    MockRoute chunked;
+    chunked.path = "/chunked";
+    chunked.chunkSize = 1024;
+    chunked.contentType = "text/plain";
+    chunked.body = QByteArray(64 * 1024, 'x');
+    routes.append(chunked);
+    
+    MockRoute drip;
+    drip.path = "/drip";
+    drip.dripBytesPerSecond = 1024;
+    drip.contentType = "text/plain";
+    drip.body = QByteArray(4 * 1024, 'x');
+    routes.append(drip);
+    
+    MockRoute flaky;
+    flaky.path = "/flaky";
+    flaky.errorRate = 0.2;
+    flaky.errorStatusCode = 503;
+    flaky.body = "{\"flaky\": true}";
+    routes.append(flaky);
+    
+    MockRoute ok;
+    ok.path = "*";
+    ok.body = "{\"status\": \"ok\"}";
+    routes.append(ok);
+    
+    return routes;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("API Tester Mock Server");
+    app.setApplicationVersion("1.0.0");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serves canned HTTP responses on localhost for tests and load runs.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QCommandLineOption portOption({"p", "port"}, "Port to listen on; 0 picks a free one.", "port", "8080");
+    QCommandLineOption bindOption({"b", "bind"}, "Address to listen on.", "address", "127.0.0.1");
+    QCommandLineOption routesOption({"r", "routes"}, "JSON file with an array of routes.", "path");
+    QCommandLineOption seedOption("seed", "Seed for latency jitter and injected errors.", "seed", "1");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Log each request to stderr.");
+    parser.addOptions({portOption, bindOption, routesOption, seedOption, verboseOption});
+    parser.process(app);
+    
+    MockHttpServer server;
+    server.setSeed(parser.value(seedOption).toUInt());
+    
+    if (parser.isSet(routesOption)) {
+        QFile file(parser.value(routesOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Failed to open %s: %s\n", qPrintable(file.fileName()), qPrintable(file.errorString()));
+            return 2;
+        }
+        
+        QJsonParseError error;
+        QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        if (!document.isArray()) {
+            fprintf(stderr, "Invalid routes file %s: %s\n", qPrintable(file.fileName()),
+                    qPrintable(error.error != QJsonParseError::NoError ? error.errorString()
+                                                                       : QString("expected an array")));
+            return 2;
+        }
+        server.setRoutes(MockHttpServer::routesFromJson(document.array()));
+    } else {
+        server.setRoutes(defaultRoutes());
+    }
+    
+    if (parser.isSet(verboseOption)) {
+        QObject::connect(&server, &MockHttpServer::requestReceived,
+                         [](const QString &method, const QString &path, int statusCode) {
+            fprintf(stderr, "%d %s %s\n", statusCode, qPrintable(method), qPrintable(path));
+        });
+    }
+    
+    QHostAddress address(parser.value(bindOption));
+    if (address.isNull() || !server.listen(address, quint16(parser.value(portOption).toUInt()))) {
+        fprintf(stderr, "Failed to listen on %s:%s\n", qPrintable(parser.value(bindOption)),
+                qPrintable(parser.value(portOption)));
+        return 2;
+    }
+    
+    fprintf(stderr, "Mock server listening on %s\n", qPrintable(server.baseUrl()));
+    return app.exec();
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "NetworkPool.h"
+#include "ConfigManager.h"
+#include <QtCore/QSharedPointer>
+
+NetworkPool* NetworkPool::s_instance = nullptr;
+
+double ConnectionPoolStats::reuseRatio() const
+{
+    qint64 connections = newConnections + reusedConnections;
+    return connections > 0 ? double(reusedConnections) / connections : 0.0;
+}
+
+QString ConnectionPoolStats::toText() const
+{
+    return QString("%1 requests: %2 on new connections, %3 on reused connections (%4% reused), "
+                   "%5 over HTTP/2. Idle connections closed %6 times.")
+        .arg(requests)
+        .arg(newConnections)
+        .arg(reusedConnections)
+        .arg(reuseRatio() * 100.0, 0, 'f', 1)
+        .arg(http2Requests)
+        .arg(idleCloses);
+}
+
+NetworkPool* NetworkPool::instance()
+{
+    if (!s_instance) {
+        s_instance = new NetworkPool();
+    }
+    return s_instance;
+}
+
+NetworkPool::NetworkPool(QObject *parent)
+    : QObject(parent)
+    , m_manager(new QNetworkAccessManager(this))
+    , m_inFlight(0)
+    , m_idleTimeoutSeconds(0)
+    , m_maxConnectionsPerHost(ConfigManager::instance()->getMaxConcurrentRequestsPerHost())
+    , m_nextSlotTicket(1)
+    , m_http2Allowed(ConfigManager::instance()->isHttp2Allowed())
+{
+    qRegisterMetaType<ConnectionPoolStats>();
+    
+    m_idleTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, this, &NetworkPool::closeIdleConnections);
+    setIdleTimeout(ConfigManager::instance()->getConnectionIdleTimeout());
+}
+
+void NetworkPool::setIdleTimeout(int seconds)
+{
+    m_idleTimeoutSeconds = qMax(0, seconds);
+    m_idleTimer.setInterval(m_idleTimeoutSeconds * 1000);
+    
+    if (m_idleTimeoutSeconds == 0) {
+        m_idleTimer.stop();
+    } else if (m_inFlight == 0 && !m_hosts.isEmpty()) {
+        m_idleTimer.start();
+    }
+}
+
+void NetworkPool::setMaxConnectionsPerHost(int maxConnections)
+{
+    m_maxConnectionsPerHost = maxConnections;
+    
+    // A higher limit may let waiting requests start right away
+    const QList<QString> hosts = m_slots.keys();
+    for (const QString &host : hosts) {
+        startWaiting(host);
+    }
+}
+
+QString NetworkPool::hostKey(const QUrl &url)
+{
+    bool secure = url.scheme() == "https";
+    return QString("%1://%2:%3").arg(url.scheme(), url.host()).arg(url.port(secure ? 443 : 80));
+}
+
+int NetworkPool::acquireSlot(const QString &hostKey, const std::function<void()> &start)
+{
+    HostSlots &host = m_slots[hostKey];
+    if (host.waiting.isEmpty() && (m_maxConnectionsPerHost < 1 || host.active < m_maxConnectionsPerHost)) {
+        ++host.active;
+        start();
+        return 0;
+    }
+    
+    SlotWaiter waiter;
+    waiter.ticket = m_nextSlotTicket++;
+    waiter.start = start;
+    host.waiting.enqueue(waiter);
+    return waiter.ticket;
+}
+
+void NetworkPool::cancelSlot(const QString &hostKey, int ticket)
+{
+    auto it = m_slots.find(hostKey);
+    if (it == m_slots.end()) {
+        return;
+    }
+    
+    for (int i = 0; i < it->waiting.size(); ++i) {
+        if (it->waiting.at(i).ticket == ticket) {
+            it->waiting.removeAt(i);
+            break;
+        }
+    }
+    
+    if (it->active <= 0 && it->waiting.isEmpty()) {
+        m_slots.erase(it);
+    }
+}
+
+void NetworkPool::releaseSlot(const QString &hostKey)
+{
+    auto it = m_slots.find(hostKey);
+    if (it == m_slots.end()) {
+        return;
+    }
+    
+    --it->active;
+    startWaiting(hostKey);
+}
+
+void NetworkPool::startWaiting(const QString &hostKey)
+{
+    forever {
+        // Looked up again each time; a started request may acquire or
+        // release slots of its own
+        auto it = m_slots.find(hostKey);
+        if (it == m_slots.end()) {
+            return;
+        }
+        
+        if (it->waiting.isEmpty() || (m_maxConnectionsPerHost > 0 && it->active >= m_maxConnectionsPerHost)) {
+            if (it->active <= 0 && it->waiting.isEmpty()) {
+                m_slots.erase(it);
+            }
+            return;
+        }
+        
+        SlotWaiter waiter = it->waiting.dequeue();
+        ++it->active;
+        waiter.start();
+    }
+}
+
+void NetworkPool::prepareRequest(QNetworkRequest &request) const
+{
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, m_http2Allowed);
+}
+
+void NetworkPool::trackReply(QNetworkReply *reply)
+{
+    QUrl url = reply->url();
+    bool secure = url.scheme() == "https";
+    QString hostKey = NetworkPool::hostKey(url);
+    
+    m_idleTimer.stop();
+    ++m_inFlight;
+    ++m_stats.requests;
+    
+    HostState &host = m_hosts[hostKey];
+    ++host.inFlight;
+    if (!secure) {
+        if (host.inFlight > host.openConnections) {
+            host.openConnections = qMin(host.inFlight, int(QtConnectionsPerHost));
+            ++m_stats.newConnections;
+        } else {
+            ++m_stats.reusedConnections;
+        }
+    }
+    
+    // finished is not emitted for a reply deleted while still running, so
+    // destroyed settles it too; whichever comes first wins
+    QSharedPointer<bool> done(new bool(false));
+    QSharedPointer<bool> handshake(new bool(false));
+#ifndef QT_NO_SSL
+    connect(reply, &QNetworkReply::encrypted, this, [handshake]() {
+        *handshake = true;
+    });
+#endif
+    connect(reply, &QNetworkReply::finished, this, [this, reply, hostKey, secure, done, handshake]() {
+        if (!*done) {
+            *done = true;
+            onReplyDone(hostKey, secure, *handshake,
+                        reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+        }
+    });
+    connect(reply, &QObject::destroyed, this, [this, hostKey, secure, done, handshake]() {
+        if (!*done) {
+            *done = true;
+            onReplyDone(hostKey, secure, *handshake, false);
+        }
+    });
+}
+
+void NetworkPool::onReplyDone(const QString &hostKey, bool secure, bool handshake, bool http2)
+{
+    if (secure) {
+        if (handshake) {
+            ++m_stats.newConnections;
+        } else {
+            ++m_stats.reusedConnections;
+        }
+    }
+    if (http2) {
+        ++m_stats.http2Requests;
+    }
+    
+    auto it = m_hosts.find(hostKey);
+    if (it != m_hosts.end()) {
+        --it->inFlight;
+    }
+    
+    if (--m_inFlight == 0 && m_idleTimeoutSeconds > 0) {
+        m_idleTimer.start();
+    }
+    
+    emit statsChanged(m_stats);
+}
+
+bool NetworkPool::closeIdleConnections()
+{
+    if (m_inFlight > 0) {
+        return false;
+    }
+    
+    m_manager->clearConnectionCache();
+    m_hosts.clear();
+    ++m_stats.idleCloses;
+    emit statsChanged(m_stats);
+    return true;
+}
+
+void NetworkPool::resetStats()
+{
+    m_stats = ConnectionPoolStats();
+    emit statsChanged(m_stats);
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#ifndef NETWORKPOOL_H
+#define NETWORKPOOL_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QQueue>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+#include <functional>
+
+struct ConnectionPoolStats
+{
+    ConnectionPoolStats()
+        : requests(0), newConnections(0), reusedConnections(0), http2Requests(0), idleCloses(0) {}
+    
+    // Share of requests that went out on an already open connection
+    double reuseRatio() const;
+    QString toText() const;
+    
+    qint64 requests;
+    qint64 newConnections;
+    qint64 reusedConnections;
+    qint64 http2Requests;
+    // Times the idle timeout closed the pooled connections
+    qint64 idleCloses;
+};
+
+// The QNetworkAccessManager shared by every HttpClient, TestRunner and
+// LoadTester, so request tabs and test runs reuse each other's keep-alive
+// connections and TLS sessions. Lives on the main thread.
+//
+// Qt does not report whether a reply reused a connection. For https a reply
+// that performs a TLS handshake is counted as a new connection. For plain
+// http a new connection is assumed whenever more requests to a host are in
+// flight than at any point since the pool was last emptied.
+class NetworkPool : public QObject
+{
+    Q_OBJECT
+    
+public:
+    // Qt opens at most this many HTTP/1.1 connections per host
+    static const int QtConnectionsPerHost = 6;
+    
+    static NetworkPool *instance();
+    
+    QNetworkAccessManager *manager() const { return m_manager; }
+    
+    // Lets https requests negotiate HTTP/2, multiplexing them over a
+    // single connection per host
+    void setHttp2Allowed(bool allowed) { m_http2Allowed = allowed; }
+    bool isHttp2Allowed() const { return m_http2Allowed; }
+    
+    // Seconds with nothing in flight before open connections are closed;
+    // 0 leaves them to Qt and the server
+    void setIdleTimeout(int seconds);
+    int idleTimeout() const { return m_idleTimeoutSeconds; }
+    
+    // Requests sent to one host at once by all clients of the pool together;
+    // values below 1 disable the limit, and Qt itself never opens more than
+    // QtConnectionsPerHost HTTP/1.1 connections
+    void setMaxConnectionsPerHost(int maxConnections);
+    int maxConnectionsPerHost() const { return m_maxConnectionsPerHost; }
+    
+    // Per-host slots enforcing maxConnectionsPerHost(), in request order.
+    // start runs as soon as the host has a free slot, before acquireSlot()
+    // returns if there is one already; the returned ticket is then 0, and
+    // otherwise identifies the waiting request for cancelSlot(). Every
+    // started request must give its slot back with releaseSlot().
+    int acquireSlot(const QString &hostKey, const std::function<void()> &start);
+    void cancelSlot(const QString &hostKey, int ticket);
+    void releaseSlot(const QString &hostKey);
+    static QString hostKey(const QUrl &url);
+    
+    // Applies the pool settings to a request before it is sent
+    void prepareRequest(QNetworkRequest &request) const;
+    // Counts a sent reply towards the statistics
+    void trackReply(QNetworkReply *reply);
+    
+    // Closes pooled connections; does nothing while requests are in flight
+    bool closeIdleConnections();
+    
+    ConnectionPoolStats stats() const { return m_stats; }
+    void resetStats();
+    
+signals:
+    void statsChanged(const ConnectionPoolStats &stats);
+    
+private:
+    struct HostState
+    {
+        HostState() : inFlight(0), openConnections(0) {}
+        
+        int inFlight;
+        // Connections Qt is assumed to hold open to the host
+        int openConnections;
+    };
+    
+    struct SlotWaiter
+    {
+        int ticket;
+        std::function<void()> start;
+    };
+    
+    struct HostSlots
+    {
+        HostSlots() : active(0) {}
+        
+        int active;
+        QQueue<SlotWaiter> waiting;
+    };
+    
+    explicit NetworkPool(QObject *parent = nullptr);
+    void onReplyDone(const QString &hostKey, bool secure, bool handshake, bool http2);
+    void startWaiting(const QString &hostKey);
+    
+    static NetworkPool *s_instance;
+    QNetworkAccessManager *m_manager;
+    QTimer m_idleTimer;
+    QHash<QString, HostState> m_hosts;
+    QHash<QString, HostSlots> m_slots;
+    ConnectionPoolStats m_stats;
+    int m_inFlight;
+    int m_idleTimeoutSeconds;
+    int m_maxConnectionsPerHost;
+    int m_nextSlotTicket;
+    bool m_http2Allowed;
+};
+
+Q_DECLARE_METATYPE(ConnectionPoolStats)
+
+#endif // NETWORKPOOL_H
\ No newline at end of file
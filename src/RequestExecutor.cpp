@@ -0,0 +1,311 @@
+#include "RequestExecutor.h"
+#include "ConfigManager.h"
+#include "NetworkPool.h"
+#include <QtCore/QUrl>
+#include <QtCore/QTimer>
+#include <QtCore/QDebug>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QHostInfo>
+#include <QtNetwork/QHostAddress>
+
+RequestExecutor::RequestExecutor(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(NetworkPool::instance()->manager())
+    , m_maxInMemoryBodySize(ConfigManager::instance()->getMaxInMemoryResponseSize())
+    , m_nextRequestId(1)
+{
+}
+
+RequestExecutor::~RequestExecutor()
+{
+    // Replies belong to the shared network manager and would outlive the executor
+    abortAll();
+}
+
+int RequestExecutor::execute(const QString &method, const QString &url, const HttpHeaders &headers,
+                             const QString &body, const RetryPolicy &retryPolicy,
+                             const RequestTiming &timing)
+{
+    int requestId = m_nextRequestId++;
+    
+    ActiveRequest request;
+    request.method = method.toUpper();
+    request.url = url;
+    request.headers = headers;
+    request.body = body;
+    request.hostKey = NetworkPool::hostKey(QUrl(url));
+    request.hasSlot = false;
+    request.slotTicket = 0;
+    request.reply = nullptr;
+    request.retryPolicy = retryPolicy;
+    request.attempt = 1;
+    request.timing = timing;
+    if (!request.timing.isStarted()) {
+        request.timing.start();
+    }
+    request.responseBody = ResponseBuffer(m_maxInMemoryBodySize);
+    m_requests.insert(requestId, request);
+    
+    start(requestId);
+    return requestId;
+}
+
+void RequestExecutor::start(int requestId)
+{
+    // Waits while the host is at NetworkPool's per-host limit; the slot is
+    // held until the attempt finishes, and not while backing off to retry
+    const QString hostKey = m_requests[requestId].hostKey;
+    int ticket = NetworkPool::instance()->acquireSlot(hostKey, [this, requestId, hostKey]() {
+        if (!m_requests.contains(requestId)) {
+            NetworkPool::instance()->releaseSlot(hostKey);
+            return;
+        }
+        onSlotAcquired(requestId);
+    });
+    
+    auto it = m_requests.find(requestId);
+    if (it != m_requests.end() && !it->hasSlot) {
+        it->slotTicket = ticket;
+    }
+}
+
+bool RequestExecutor::isWaitingForSlot(int requestId) const
+{
+    auto it = m_requests.constFind(requestId);
+    return it != m_requests.constEnd() && !it->hasSlot;
+}
+
+void RequestExecutor::onSlotAcquired(int requestId)
+{
+    auto it = m_requests.find(requestId);
+    bool waited = it->slotTicket != 0;
+    it->hasSlot = true;
+    it->slotTicket = 0;
+    if (waited) {
+        emit slotAcquired(requestId);
+        if (!m_requests.contains(requestId)) {
+            return; // Aborted by a receiver
+        }
+    }
+    
+    ActiveRequest &request = m_requests[requestId];
+    
+    QString host = QUrl(request.url).host();
+    if (host.isEmpty() || !QHostAddress(host).isNull()) {
+        // Nothing to resolve for IP literals
+        dispatch(requestId);
+        return;
+    }
+    
+    // Resolving up front lets the lookup be timed on its own. The result
+    // lands in Qt's host cache, so the socket does not resolve again.
+    request.timing.markDnsStarted();
+    QHostInfo::lookupHost(host, this, [this, requestId](const QHostInfo &) {
+        auto it = m_requests.find(requestId);
+        if (it == m_requests.end()) {
+            return; // Aborted while resolving
+        }
+        it->timing.markDnsFinished();
+        dispatch(requestId);
+    });
+}
+
+void RequestExecutor::abort(int requestId)
+{
+    if (!m_requests.contains(requestId)) {
+        return;
+    }
+    
+    ActiveRequest request = m_requests.take(requestId);
+    QNetworkReply *reply = request.reply;
+    if (reply) {
+        // Disconnect first so abort() does not report the request as finished
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+        m_replyIds.remove(reply);
+    }
+    
+    releaseSlot(request);
+}
+
+void RequestExecutor::releaseSlot(ActiveRequest &request)
+{
+    if (request.hasSlot) {
+        request.hasSlot = false;
+        NetworkPool::instance()->releaseSlot(request.hostKey);
+    } else if (request.slotTicket > 0) {
+        NetworkPool::instance()->cancelSlot(request.hostKey, request.slotTicket);
+        request.slotTicket = 0;
+    }
+}
+
+void RequestExecutor::abortAll()
+{
+    const QList<int> ids = m_requests.keys();
+    for (int id : ids) {
+        abort(id);
+    }
+}
+
+QNetworkRequest RequestExecutor::createRequest(const QString &url, const HttpHeaders &headers)
+{
+    QNetworkRequest request;
+    request.setUrl(QUrl(url));
+    
+    // Set default headers
+    request.setHeader(QNetworkRequest::UserAgentHeader, "ApiTester/1.0");
+    request.setRawHeader("Accept", "*/*");
+    
+    // Set custom headers
+    headers.applyTo(request);
+    
+    return request;
+}
+
+QNetworkReply *RequestExecutor::send(const QNetworkRequest &request, const QString &method, const QByteArray &body)
+{
+    if (method == "GET") {
+        return m_networkManager->get(request);
+    } else if (method == "POST") {
+        return m_networkManager->post(request, body);
+    } else if (method == "PUT") {
+        return m_networkManager->put(request, body);
+    } else if (method == "DELETE") {
+        return m_networkManager->deleteResource(request);
+    } else if (method == "HEAD") {
+        return m_networkManager->head(request);
+    } else if (method == "PATCH") {
+        return m_networkManager->sendCustomRequest(request, "PATCH", body);
+    } else if (method == "OPTIONS") {
+        return m_networkManager->sendCustomRequest(request, "OPTIONS");
+    }
+    
+    // Default to GET for unknown methods
+    return m_networkManager->get(request);
+}
+
+void RequestExecutor::dispatch(int requestId)
+{
+    ActiveRequest &active = m_requests[requestId];
+    QNetworkRequest request = createRequest(active.url, active.headers);
+    NetworkPool::instance()->prepareRequest(request);
+    
+    active.timing.markDispatched();
+    QNetworkReply *reply = send(request, active.method, active.body.toUtf8());
+    active.reply = reply;
+    m_replyIds.insert(reply, requestId);
+    NetworkPool::instance()->trackReply(reply);
+    
+    // Drain the reply as data arrives so the body is never buffered twice
+    connect(reply, &QNetworkReply::readyRead, this, [this, requestId, reply]() {
+        auto it = m_requests.find(requestId);
+        if (it == m_requests.end()) {
+            return;
+        }
+        it->timing.markFirstByte();
+        
+        QByteArray chunk = reply->readAll();
+        if (!it->responseBody.append(chunk)) {
+            // Finishes the request with the buffer's error; the body is incomplete
+            reply->abort();
+            return;
+        }
+        emit chunkReceived(requestId, chunk);
+    });
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, requestId](qint64 received, qint64 total) {
+        emit downloadProgress(requestId, received, total);
+    });
+#ifndef QT_NO_SSL
+    connect(reply, &QNetworkReply::encrypted, this, [this, requestId]() {
+        auto it = m_requests.find(requestId);
+        if (it != m_requests.end()) {
+            it->timing.markEncrypted();
+        }
+    });
+#endif
+    connect(reply, &QNetworkReply::finished, this, &RequestExecutor::onReplyFinished);
+}
+
+void RequestExecutor::onReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply || !m_replyIds.contains(reply)) {
+        return;
+    }
+    
+    int requestId = m_replyIds.take(reply);
+    ActiveRequest request = m_requests.take(requestId);
+    reply->deleteLater();
+    releaseSlot(request);
+    
+    request.timing.markFinished();
+    request.responseBody.append(reply->readAll());
+    request.responseBody.finish();
+    
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    QString errorString;
+    
+    // Handle network errors
+    if (reply->error() != QNetworkReply::NoError && statusCode == 0) {
+        errorString = reply->errorString();
+        statusCode = -1;
+    }
+    
+    // The body could not be stored, so the reply was aborted part way
+    if (request.responseBody.hasError()) {
+        errorString = request.responseBody.errorString();
+        statusCode = -1;
+    }
+    
+    // The body bytes are shared from here on, never copied or re-encoded
+    HttpResponse response(statusCode, request.responseBody, HttpHeaders::fromReply(reply),
+                          request.timing, errorString, reply->error());
+    
+    if (scheduleRetry(requestId, request, response)) {
+        return;
+    }
+    
+    if (!request.previousAttempts.isEmpty()) {
+        response = response.withPreviousAttempts(request.previousAttempts);
+    }
+    emit finished(requestId, response);
+}
+
+bool RequestExecutor::scheduleRetry(int requestId, ActiveRequest &request, const HttpResponse &response)
+{
+    if (!request.retryPolicy.shouldRetry(request.method, response, request.attempt)) {
+        return false;
+    }
+    
+    qint64 backoffMs = request.retryPolicy.backoffMs(response, request.attempt);
+    if (backoffMs < 0) {
+        return false; // Retry-After asks for more than the policy allows
+    }
+    
+    RequestAttempt attempt;
+    attempt.statusCode = response.statusCode();
+    attempt.errorString = response.errorString();
+    attempt.timing = request.timing;
+    attempt.backoffMs = backoffMs;
+    request.previousAttempts.append(attempt);
+    
+    // Every attempt gets a clock and a body of its own
+    request.attempt++;
+    request.reply = nullptr;
+    request.timing = RequestTiming();
+    request.responseBody = ResponseBuffer(m_maxInMemoryBodySize);
+    m_requests.insert(requestId, request);
+    
+    emit retrying(requestId, request.attempt, backoffMs);
+    
+    QTimer::singleShot(int(backoffMs), this, [this, requestId]() {
+        auto it = m_requests.find(requestId);
+        if (it == m_requests.end()) {
+            return; // Aborted while backing off
+        }
+        it->timing.start();
+        start(requestId);
+    });
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef REQUESTEXECUTOR_H
+#define REQUESTEXECUTOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include "HttpHeaders.h"
+#include "HttpResponse.h"
+#include "RequestTiming.h"
+#include "ResponseBuffer.h"
+#include "RetryPolicy.h"
+
+// Builds, dispatches and captures HTTP requests for HttpClient, TestRunner
+// and LoadTester. Requests go out on the shared NetworkPool manager once the
+// pool grants a slot for their host, so its per-host limit holds across all
+// clients; other bookkeeping is left to the caller. Each request resolves
+// its host first so the lookup is timed on its own,
+// and the body is drained into a ResponseBuffer as it arrives. Failed
+// attempts are retried as the request's RetryPolicy allows.
+class RequestExecutor : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit RequestExecutor(QObject *parent = nullptr);
+    ~RequestExecutor();
+    
+    // Sends the request and returns its id. A started timing is continued,
+    // so time spent queued, by the caller or for a host slot, shows up in
+    // the first attempt.
+    int execute(const QString &method, const QString &url, const HttpHeaders &headers,
+                const QString &body, const RetryPolicy &retryPolicy = RetryPolicy(),
+                const RequestTiming &timing = RequestTiming());
+    // Drops the request without emitting finished(), also while it waits to be retried
+    void abort(int requestId);
+    void abortAll();
+    
+    bool isActive(int requestId) const { return m_requests.contains(requestId); }
+    int activeCount() const { return m_requests.size(); }
+    // True while the request waits for a per-host slot (see slotAcquired)
+    bool isWaitingForSlot(int requestId) const;
+    
+    // Response bodies larger than this are spilled to a temporary file
+    void setMaxInMemoryBodySize(qint64 maxBytes) { m_maxInMemoryBodySize = maxBytes; }
+    qint64 maxInMemoryBodySize() const { return m_maxInMemoryBodySize; }
+    
+    // Builds the request for a URL with the default headers plus the given ones
+    static QNetworkRequest createRequest(const QString &url, const HttpHeaders &headers);
+    
+signals:
+    // Body data of the current attempt as it arrives
+    void chunkReceived(int requestId, const QByteArray &chunk);
+    // The attempt failed and will be sent again after backoffMs; chunks
+    // received so far are discarded
+    void retrying(int requestId, int nextAttempt, qint64 backoffMs);
+    void downloadProgress(int requestId, qint64 bytesReceived, qint64 bytesTotal);
+    // The request got a per-host slot and is being sent; not emitted when
+    // the slot was free right away, i.e. during execute()
+    void slotAcquired(int requestId);
+    // Network errors finish with a status code of -1 (see HttpResponse).
+    // After retries the response is the last attempt's and lists the others.
+    void finished(int requestId, const HttpResponse &response);
+    
+private slots:
+    void onReplyFinished();
+    
+private:
+    struct ActiveRequest
+    {
+        QString method;
+        QString url;
+        HttpHeaders headers;
+        QString body;
+        QString hostKey;
+        // Holds one of the host's NetworkPool slots
+        bool hasSlot;
+        // Waiting for a slot when positive
+        int slotTicket;
+        QNetworkReply *reply;
+        RetryPolicy retryPolicy;
+        // Counts from 1
+        int attempt;
+        QVector<RequestAttempt> previousAttempts;
+        RequestTiming timing;
+        ResponseBuffer responseBody;
+    };
+    
+    void start(int requestId);
+    void onSlotAcquired(int requestId);
+    void releaseSlot(ActiveRequest &request);
+    void dispatch(int requestId);
+    // Schedules another attempt; false when the policy says to give up
+    bool scheduleRetry(int requestId, ActiveRequest &request, const HttpResponse &response);
+    QNetworkReply *send(const QNetworkRequest &request, const QString &method, const QByteArray &body);
+    
+    // Shared; owned by NetworkPool
+    QNetworkAccessManager *m_networkManager;
+    QHash<int, ActiveRequest> m_requests;
+    QHash<QNetworkReply*, int> m_replyIds;
+    qint64 m_maxInMemoryBodySize;
+    int m_nextRequestId;
+};
+
+#endif // REQUESTEXECUTOR_H
\ No newline at end of file
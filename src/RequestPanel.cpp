@@ -24,6 +24,12 @@ RequestPanel::RequestPanel(QWidget *parent)
     
     connect(m_httpClient, &HttpClient::responseReceived, 
             this, &RequestPanel::onResponseReceived);
+    connect(m_httpClient, &HttpClient::responseChunk,
+            this, [this](int, const QByteArray &chunk) { emit responseChunk(chunk); });
+    connect(m_httpClient, &HttpClient::downloadProgress,
+            this, [this](int, qint64 received, qint64 total) { emit downloadProgress(received, total); });
+    connect(m_httpClient, &HttpClient::requestRetrying,
+            this, [this](int, int nextAttempt, qint64 backoffMs) { emit requestRetrying(nextAttempt, backoffMs); });
     connect(m_httpClient, &HttpClient::requestFinished,
             this, &RequestPanel::requestFinished);
 }
@@ -267,21 +273,17 @@ void RequestPanel::sendRequest()
     }
     
     populateHeadersFromTable();
-    QString headers = getHeaders();
+    HttpHeaders headers = getHeaders();
     
-    // Add authentication headers
+    // Add authentication headers, replacing any typed into the table
     QString authType = m_authTypeCombo->currentText();
     if (authType == "Basic Auth" && !m_usernameEdit->text().isEmpty()) {
         QString credentials = QString("%1:%2").arg(m_usernameEdit->text(), m_passwordEdit->text());
-        QByteArray encoded = credentials.toUtf8().toBase64();
-        if (!headers.isEmpty()) headers += "\n";
-        headers += QString("Authorization: Basic %1").arg(QString::fromUtf8(encoded));
+        headers.set("Authorization", "Basic " + credentials.toUtf8().toBase64());
     } else if (authType == "Bearer Token" && !m_tokenEdit->text().isEmpty()) {
-        if (!headers.isEmpty()) headers += "\n";
-        headers += QString("Authorization: Bearer %1").arg(m_tokenEdit->text());
+        headers.set("Authorization", "Bearer " + m_tokenEdit->text().toUtf8());
     } else if (authType == "API Key" && !m_tokenEdit->text().isEmpty()) {
-        if (!headers.isEmpty()) headers += "\n";
-        headers += QString("X-API-Key: %1").arg(m_tokenEdit->text());
+        headers.set("X-API-Key", m_tokenEdit->text().toUtf8());
     }
     
     QString body;
@@ -293,15 +295,12 @@ void RequestPanel::sendRequest()
         if (bodyType == "raw" && !body.isEmpty()) {
             // Try to detect JSON
             if (body.trimmed().startsWith('{') || body.trimmed().startsWith('[')) {
-                if (!headers.isEmpty()) headers += "\n";
-                headers += "Content-Type: application/json";
+                headers.set("Content-Type", "application/json");
             } else {
-                if (!headers.isEmpty()) headers += "\n";
-                headers += "Content-Type: text/plain";
+                headers.set("Content-Type", "text/plain");
             }
         } else if (bodyType == "x-www-form-urlencoded") {
-            if (!headers.isEmpty()) headers += "\n";
-            headers += "Content-Type: application/x-www-form-urlencoded";
+            headers.set("Content-Type", "application/x-www-form-urlencoded");
         }
     }
     
@@ -309,10 +308,11 @@ void RequestPanel::sendRequest()
     m_httpClient->sendRequest(method, url, headers, body);
 }
 
-void RequestPanel::onResponseReceived(const QString &response, int statusCode, 
-                                    qint64 responseTime, const QString &headers)
+void RequestPanel::onResponseReceived(int requestId, const HttpResponse &response)
 {
-    emit responseReceived(response, statusCode, responseTime, headers);
+    Q_UNUSED(requestId)
+    
+    emit responseReceived(response);
 }
 
 void RequestPanel::addHeader()
@@ -367,20 +367,20 @@ QString RequestPanel::getUrl() const
     return m_urlEdit->text();
 }
 
-QString RequestPanel::getHeaders() const
+HttpHeaders RequestPanel::getHeaders() const
 {
-    QStringList headersList;
+    HttpHeaders headers;
     for (int row = 0; row < m_headersTable->rowCount(); ++row) {
         QCheckBox *enabledCheck = qobject_cast<QCheckBox*>(m_headersTable->cellWidget(row, 0));
         if (enabledCheck && enabledCheck->isChecked()) {
             QTableWidgetItem *keyItem = m_headersTable->item(row, 1);
             QTableWidgetItem *valueItem = m_headersTable->item(row, 2);
             if (keyItem && valueItem && !keyItem->text().trimmed().isEmpty()) {
-                headersList << QString("%1: %2").arg(keyItem->text().trimmed(), valueItem->text());
+                headers.append(keyItem->text().trimmed().toUtf8(), valueItem->text().trimmed().toUtf8());
             }
         }
     }
-    return headersList.join('\n');
+    return headers;
 }
 
 QString RequestPanel::getBody() const
@@ -420,33 +420,26 @@ void RequestPanel::setUrl(const QString &url)
     m_urlEdit->setText(url);
 }
 
-void RequestPanel::setHeaders(const QString &headers)
+void RequestPanel::setHeaders(const HttpHeaders &headers)
 {
     // Clear existing headers
     m_headersTable->setRowCount(0);
     
-    // Parse headers and populate table
-    QStringList headerLines = headers.split('\n', Qt::SkipEmptyParts);
-    for (const QString &line : headerLines) {
-        int colonIndex = line.indexOf(':');
-        if (colonIndex > 0) {
-            QString key = line.left(colonIndex).trimmed();
-            QString value = line.mid(colonIndex + 1).trimmed();
-            
-            int row = m_headersTable->rowCount();
-            m_headersTable->insertRow(row);
-            
-            QCheckBox *enabledCheck = new QCheckBox();
-            enabledCheck->setChecked(true);
-            m_headersTable->setCellWidget(row, 0, enabledCheck);
-            
-            m_headersTable->setItem(row, 1, new QTableWidgetItem(key));
-            m_headersTable->setItem(row, 2, new QTableWidgetItem(value));
-        }
+    // Populate table
+    for (const HttpHeaders::Header &header : headers) {
+        int row = m_headersTable->rowCount();
+        m_headersTable->insertRow(row);
+        
+        QCheckBox *enabledCheck = new QCheckBox();
+        enabledCheck->setChecked(true);
+        m_headersTable->setCellWidget(row, 0, enabledCheck);
+        
+        m_headersTable->setItem(row, 1, new QTableWidgetItem(QString::fromUtf8(header.first)));
+        m_headersTable->setItem(row, 2, new QTableWidgetItem(QString::fromUtf8(header.second)));
     }
     
     // Add empty row for new headers
-    if (headerLines.isEmpty()) {
+    if (headers.isEmpty()) {
         addHeader();
     }
 }
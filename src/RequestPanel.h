@@ -8,6 +8,8 @@
 #include <QtWidgets/QTabWidget>
 #include <QtWidgets/QTableWidget>
 #include <QtWidgets/QTextEdit>
+#include "HttpHeaders.h"
+#include "HttpResponse.h"
 
 class HttpClient;
 class JsonSyntaxHighlighter;
@@ -22,24 +24,28 @@ public:
     
     QString getMethod() const;
     QString getUrl() const;
-    QString getHeaders() const;
+    HttpHeaders getHeaders() const;
     QString getBody() const;
     QString getParameters() const;
     
     void setMethod(const QString &method);
     void setUrl(const QString &url);
-    void setHeaders(const QString &headers);
+    void setHeaders(const HttpHeaders &headers);
     void setBody(const QString &body);
     void setParameters(const QString &parameters);
     
 signals:
-    void responseReceived(const QString &response, int statusCode, qint64 responseTime, const QString &headers);
+    void responseReceived(const HttpResponse &response);
+    void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
+    // Body bytes as they arrive, before responseReceived
+    void responseChunk(const QByteArray &chunk);
     void requestStarted();
+    void requestRetrying(int nextAttempt, qint64 backoffMs);
     void requestFinished();
     
 private slots:
     void sendRequest();
-    void onResponseReceived(const QString &response, int statusCode, qint64 responseTime, const QString &headers);
+    void onResponseReceived(int requestId, const HttpResponse &response);
     void addHeader();
     void removeHeader();
     void addParameter();
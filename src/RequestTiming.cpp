@@ -0,0 +1,137 @@
+#include "RequestTiming.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+RequestTiming::RequestTiming()
+    : m_dnsStartedNs(-1)
+    , m_dnsFinishedNs(-1)
+    , m_dispatchedNs(-1)
+    , m_encryptedNs(-1)
+    , m_firstByteNs(-1)
+    , m_finishedNs(-1)
+{
+}
+
+void RequestTiming::start()
+{
+    *this = RequestTiming();
+    m_clock.start();
+}
+
+qint64 RequestTiming::elapsed() const
+{
+    return m_clock.isValid() ? m_clock.nsecsElapsed() : -1;
+}
+
+void RequestTiming::markDnsStarted()
+{
+    m_dnsStartedNs = elapsed();
+}
+
+void RequestTiming::markDnsFinished()
+{
+    m_dnsFinishedNs = elapsed();
+}
+
+void RequestTiming::markDispatched()
+{
+    m_dispatchedNs = elapsed();
+}
+
+void RequestTiming::markEncrypted()
+{
+    if (m_encryptedNs < 0) {
+        m_encryptedNs = elapsed();
+    }
+}
+
+void RequestTiming::markFirstByte()
+{
+    if (m_firstByteNs < 0) {
+        m_firstByteNs = elapsed();
+    }
+}
+
+void RequestTiming::markFinished()
+{
+    m_finishedNs = elapsed();
+    
+    // Replies without a body never emit readyRead
+    if (m_firstByteNs < 0) {
+        m_firstByteNs = m_finishedNs;
+    }
+}
+
+qint64 RequestTiming::queuedNs() const
+{
+    qint64 startedNs = m_dnsStartedNs >= 0 ? m_dnsStartedNs : m_dispatchedNs;
+    return startedNs >= 0 ? startedNs : -1;
+}
+
+qint64 RequestTiming::dnsLookupNs() const
+{
+    if (m_dnsStartedNs < 0 || m_dnsFinishedNs < 0) {
+        return -1;
+    }
+    return m_dnsFinishedNs - m_dnsStartedNs;
+}
+
+qint64 RequestTiming::connectNs() const
+{
+    if (m_dispatchedNs < 0 || m_encryptedNs < 0) {
+        return -1;
+    }
+    return m_encryptedNs - m_dispatchedNs;
+}
+
+qint64 RequestTiming::timeToFirstByteNs() const
+{
+    qint64 sentNs = m_encryptedNs >= 0 ? m_encryptedNs : m_dispatchedNs;
+    if (sentNs < 0 || m_firstByteNs < 0) {
+        return -1;
+    }
+    return m_firstByteNs - sentNs;
+}
+
+qint64 RequestTiming::downloadNs() const
+{
+    if (m_firstByteNs < 0 || m_finishedNs < 0) {
+        return -1;
+    }
+    return m_finishedNs - m_firstByteNs;
+}
+
+qint64 RequestTiming::totalNs() const
+{
+    return m_finishedNs;
+}
+
+QString RequestTiming::toJson() const
+{
+    QJsonObject obj;
+    obj["dnsStarted"] = m_dnsStartedNs;
+    obj["dnsFinished"] = m_dnsFinishedNs;
+    obj["dispatched"] = m_dispatchedNs;
+    obj["encrypted"] = m_encryptedNs;
+    obj["firstByte"] = m_firstByteNs;
+    obj["finished"] = m_finishedNs;
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+RequestTiming RequestTiming::fromJson(const QString &json)
+{
+    RequestTiming timing;
+    QJsonObject obj = QJsonDocument::fromJson(json.toUtf8()).object();
+    if (obj.isEmpty()) {
+        return timing;
+    }
+    
+    auto mark = [&obj](const char *key) { return qint64(obj.value(QLatin1String(key)).toDouble(-1)); };
+    timing.m_dnsStartedNs = mark("dnsStarted");
+    timing.m_dnsFinishedNs = mark("dnsFinished");
+    timing.m_dispatchedNs = mark("dispatched");
+    timing.m_encryptedNs = mark("encrypted");
+    timing.m_firstByteNs = mark("firstByte");
+    timing.m_finishedNs = mark("finished");
+    return timing;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef REQUESTTIMING_H
+#define REQUESTTIMING_H
+
+#include <QtCore/QString>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaType>
+
+// Per-request timing breakdown taken from a monotonic nanosecond clock.
+// Phase durations are in nanoseconds and are -1 when the phase was not
+// observed, e.g. no DNS lookup for an IP literal or no handshake on a reused
+// connection.
+class RequestTiming
+{
+public:
+    RequestTiming();
+    
+    // Starts the clock; all marks are offsets from this point
+    void start();
+    bool isStarted() const { return m_clock.isValid(); }
+    void markDnsStarted();
+    void markDnsFinished();
+    void markDispatched();
+    void markEncrypted();
+    void markFirstByte();
+    void markFinished();
+    
+    bool isValid() const { return m_finishedNs >= 0; }
+    bool hasFirstByte() const { return m_firstByteNs >= 0; }
+    
+    // Waiting for a free per-host slot before the request could start
+    qint64 queuedNs() const;
+    qint64 dnsLookupNs() const;
+    // Qt 5 reports no separate socket-connected event, so for https this is
+    // TCP connect plus TLS handshake (up to QNetworkReply::encrypted). For a
+    // new plain http connection the connect time is folded into TTFB.
+    qint64 connectNs() const;
+    qint64 timeToFirstByteNs() const;
+    qint64 downloadNs() const;
+    qint64 totalNs() const;
+    qint64 totalMs() const { return isValid() ? totalNs() / 1000000 : 0; }
+    // Total time without the wait for a slot
+    qint64 serviceMs() const { return isValid() ? (totalNs() - qMax<qint64>(0, queuedNs())) / 1000000 : 0; }
+    
+    QString toJson() const;
+    static RequestTiming fromJson(const QString &json);
+    
+private:
+    qint64 elapsed() const;
+    
+    QElapsedTimer m_clock;
+    qint64 m_dnsStartedNs;
+    qint64 m_dnsFinishedNs;
+    qint64 m_dispatchedNs;
+    qint64 m_encryptedNs;
+    qint64 m_firstByteNs;
+    qint64 m_finishedNs;
+};
+
+Q_DECLARE_METATYPE(RequestTiming)
+
+#endif // REQUESTTIMING_H
\ No newline at end of file
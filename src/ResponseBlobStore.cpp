@@ -0,0 +1,150 @@
+#include "ResponseBlobStore.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QStringList>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+namespace {
+QString formatBytes(qint64 bytes)
+{
+    if (bytes < 1024) {
+        return QString("%1 B").arg(bytes);
+    } else if (bytes < 1024 * 1024) {
+        return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+}
+
+double ResponseStorageStats::savings() const
+{
+    if (logicalBytes <= 0) {
+        return 0.0;
+    }
+    return 1.0 - double(storedBytes) / double(logicalBytes);
+}
+
+QString ResponseStorageStats::toText() const
+{
+    return QString("%1 history responses (%2) stored as %3 unique bodies in %4, %5% smaller")
+        .arg(historyEntries)
+        .arg(formatBytes(logicalBytes))
+        .arg(uniqueBodies)
+        .arg(formatBytes(storedBytes))
+        .arg(savings() * 100.0, 0, 'f', 1);
+}
+
+bool ResponseBlobStore::createTables(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    
+    if (!query.exec(R"(
+        CREATE TABLE IF NOT EXISTS response_blobs (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            hash BLOB NOT NULL UNIQUE,
+            size INTEGER NOT NULL,
+            compressed_size INTEGER NOT NULL,
+            data BLOB NOT NULL
+        )
+    )")) {
+        qWarning() << "Failed to create response_blobs table:" << query.lastError().text();
+        return false;
+    }
+    
+    // Contentless: the text lives compressed in response_blobs only
+    QSqlQuery probe(database);
+    probe.exec("SELECT COUNT(*) FROM sqlite_master WHERE name = 'response_blobs_fts'");
+    if (probe.next() && probe.value(0).toInt() == 0
+        && !query.exec("CREATE VIRTUAL TABLE response_blobs_fts USING fts5(body, content='')")) {
+        qWarning() << "Response bodies will not be searchable:" << query.lastError().text();
+    }
+    
+    return true;
+}
+
+QByteArray ResponseBlobStore::hash(const QByteArray &body)
+{
+    return QCryptographicHash::hash(body, QCryptographicHash::Sha256);
+}
+
+qint64 ResponseBlobStore::store(QSqlDatabase &database, const QByteArray &body)
+{
+    if (body.isEmpty()) {
+        return 0;
+    }
+    
+    const QByteArray digest = hash(body);
+    
+    // Repeated bodies are the common case when polling an endpoint, so look
+    // the hash up before paying for compression
+    QSqlQuery query(database);
+    query.prepare("SELECT id FROM response_blobs WHERE hash = ?");
+    query.addBindValue(digest);
+    if (!query.exec()) {
+        qWarning() << "Failed to look up response blob:" << query.lastError().text();
+        return -1;
+    }
+    if (query.next()) {
+        return query.value(0).toLongLong();
+    }
+    
+    const QByteArray compressed = qCompress(body);
+    query.prepare("INSERT INTO response_blobs (hash, size, compressed_size, data) VALUES (?, ?, ?, ?)");
+    query.addBindValue(digest);
+    query.addBindValue(body.size());
+    query.addBindValue(compressed.size());
+    query.addBindValue(compressed);
+    if (!query.exec()) {
+        qWarning() << "Failed to store response blob:" << query.lastError().text();
+        return -1;
+    }
+    
+    qint64 blobId = query.lastInsertId().toLongLong();
+    
+    QSqlQuery index(database);
+    index.prepare("INSERT INTO response_blobs_fts (rowid, body) VALUES (?, ?)");
+    index.addBindValue(blobId);
+    index.addBindValue(QString::fromUtf8(body));
+    if (!index.exec()) {
+        qWarning() << "Failed to index response blob:" << index.lastError().text();
+    }
+    
+    return blobId;
+}
+
+QByteArray ResponseBlobStore::load(QSqlDatabase &database, qint64 blobId)
+{
+    if (blobId <= 0) {
+        return QByteArray();
+    }
+    
+    QSqlQuery query(database);
+    query.prepare("SELECT data FROM response_blobs WHERE id = ?");
+    query.addBindValue(blobId);
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Failed to load response blob" << blobId << ":" << query.lastError().text();
+        return QByteArray();
+    }
+    
+    return qUncompress(query.value(0).toByteArray());
+}
+
+ResponseStorageStats ResponseBlobStore::stats(QSqlDatabase &database)
+{
+    ResponseStorageStats stats;
+    QSqlQuery query(database);
+    
+    if (query.exec("SELECT COUNT(*), COALESCE(SUM(b.size), 0) FROM history h "
+                   "JOIN response_blobs b ON b.id = h.response_blob_id") && query.next()) {
+        stats.historyEntries = query.value(0).toLongLong();
+        stats.logicalBytes = query.value(1).toLongLong();
+    }
+    
+    if (query.exec("SELECT COUNT(*), COALESCE(SUM(compressed_size), 0) FROM response_blobs") && query.next()) {
+        stats.uniqueBodies = query.value(0).toLongLong();
+        stats.storedBytes = query.value(1).toLongLong();
+    }
+    
+    return stats;
+}
\ No newline at end of file
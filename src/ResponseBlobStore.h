@@ -0,0 +1,46 @@
+#ifndef RESPONSEBLOBSTORE_H
+#define RESPONSEBLOBSTORE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QMetaType>
+#include <QtSql/QSqlDatabase>
+
+struct ResponseStorageStats
+{
+    ResponseStorageStats() : historyEntries(0), uniqueBodies(0), logicalBytes(0), storedBytes(0) {}
+    
+    // Fraction of the plain-text size that deduplication and compression saved
+    double savings() const;
+    QString toText() const;
+    
+    qint64 historyEntries;
+    qint64 uniqueBodies;
+    // What the bodies would take stored inline, one copy per history entry
+    qint64 logicalBytes;
+    // Compressed size of the distinct bodies actually stored
+    qint64 storedBytes;
+};
+
+// Content-addressed storage for history response bodies. Each distinct body
+// is stored once in response_blobs, keyed by its SHA-256 and compressed with
+// qCompress; history rows reference it through response_blob_id. The body
+// text is indexed once per blob in the contentless response_blobs_fts table.
+class ResponseBlobStore
+{
+public:
+    static bool createTables(QSqlDatabase &database);
+    
+    // Returns the id of the blob holding body, storing it if it is new.
+    // Returns 0 for an empty body and -1 on error.
+    static qint64 store(QSqlDatabase &database, const QByteArray &body);
+    static QByteArray load(QSqlDatabase &database, qint64 blobId);
+    
+    static QByteArray hash(const QByteArray &body);
+    // Joins every history row to its blob; run it off the GUI thread
+    static ResponseStorageStats stats(QSqlDatabase &database);
+};
+
+Q_DECLARE_METATYPE(ResponseStorageStats)
+
+#endif // RESPONSEBLOBSTORE_H
\ No newline at end of file
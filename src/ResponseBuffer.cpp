@@ -0,0 +1,79 @@
+#include "ResponseBuffer.h"
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+
+ResponseBuffer::ResponseBuffer(qint64 maxInMemorySize)
+    : m_maxInMemorySize(qMax<qint64>(0, maxInMemorySize))
+    , m_size(0)
+{
+}
+
+bool ResponseBuffer::append(const QByteArray &chunk)
+{
+    if (chunk.isEmpty()) {
+        return true;
+    }
+    if (hasError()) {
+        return false;
+    }
+    
+    m_size += chunk.size();
+    
+    if (m_file) {
+        // Keep topping up the preview until it reaches the memory limit
+        qint64 room = m_maxInMemorySize - m_data.size();
+        if (room > 0) {
+            m_data.append(chunk.constData(), int(qMin<qint64>(room, chunk.size())));
+        }
+        if (m_file->write(chunk) != chunk.size()) {
+            return fail("Failed to write response spill file: " + m_file->errorString());
+        }
+        return true;
+    }
+    
+    m_data.append(chunk);
+    if (m_data.size() > m_maxInMemorySize) {
+        return spill();
+    }
+    
+    return true;
+}
+
+bool ResponseBuffer::spill()
+{
+    m_file.reset(new QTemporaryFile(QDir::tempPath() + "/apitester-response-XXXXXX.bin"));
+    if (!m_file->open()) {
+        return fail("Failed to create response spill file: " + m_file->errorString());
+    }
+    
+    if (m_file->write(m_data) != m_data.size()) {
+        return fail("Failed to write response spill file: " + m_file->errorString());
+    }
+    
+    // Drop everything past the preview and release the excess capacity
+    m_data = m_data.left(int(m_maxInMemorySize));
+    return true;
+}
+
+bool ResponseBuffer::fail(const QString &errorString)
+{
+    qWarning() << errorString;
+    m_errorString = errorString;
+    
+    // Keep the preview only, so a failed body cannot keep growing in memory
+    m_file.reset();
+    m_data = m_data.left(int(m_maxInMemorySize));
+    return false;
+}
+
+void ResponseBuffer::finish()
+{
+    if (m_file) {
+        m_file->flush();
+    }
+}
+
+QString ResponseBuffer::fileName() const
+{
+    return m_file ? m_file->fileName() : QString();
+}
\ No newline at end of file
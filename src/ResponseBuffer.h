@@ -0,0 +1,50 @@
+#ifndef RESPONSEBUFFER_H
+#define RESPONSEBUFFER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QMetaType>
+
+// Accumulates a response body as it streams in. Up to maxInMemorySize bytes
+// are kept in memory; once the body grows past that it is written to a
+// temporary file and only the first maxInMemorySize bytes stay in memory as
+// a preview. Copies share the spill file, which is removed with the last copy.
+// If the spill file cannot be written the buffer stops accepting data and
+// reports an error; the body it holds is then incomplete.
+class ResponseBuffer
+{
+public:
+    static constexpr qint64 DefaultMaxInMemorySize = 32 * 1024 * 1024;
+    
+    explicit ResponseBuffer(qint64 maxInMemorySize = DefaultMaxInMemorySize);
+    
+    bool append(const QByteArray &chunk);
+    // Flushes the spill file so other readers see the complete body
+    void finish();
+    
+    qint64 size() const { return m_size; }
+    qint64 maxInMemorySize() const { return m_maxInMemorySize; }
+    bool isSpilled() const { return !m_file.isNull(); }
+    bool hasError() const { return !m_errorString.isEmpty(); }
+    QString errorString() const { return m_errorString; }
+    
+    // The whole body, or only its first maxInMemorySize() bytes when spilled
+    const QByteArray &data() const { return m_data; }
+    QString fileName() const;
+    
+private:
+    bool spill();
+    bool fail(const QString &errorString);
+    
+    qint64 m_maxInMemorySize;
+    qint64 m_size;
+    QByteArray m_data;
+    QSharedPointer<QTemporaryFile> m_file;
+    QString m_errorString;
+};
+
+Q_DECLARE_METATYPE(ResponseBuffer)
+
+#endif // RESPONSEBUFFER_H
\ No newline at end of file
@@ -2,17 +2,32 @@
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QSplitter>
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonObject>
-#include <QtCore/QJsonArray>
-#include <QtCore/QJsonValue>
 #include <QtGui/QFont>
-#include <QtWidgets/QTreeWidgetItem>
+#include <QtGui/QTextCursor>
 
 ResponsePanel::ResponsePanel(QWidget *parent)
     : QWidget(parent)
+    , m_processorThread(new QThread(this))
+    , m_processor(new ResponseProcessor())
+    , m_generation(0)
+    , m_streamDecoder(nullptr)
+    , m_streamedBytes(0)
 {
     setupUI();
+    
+    qRegisterMetaType<ProcessedResponse>();
+    m_processor->moveToThread(m_processorThread);
+    connect(m_processorThread, &QThread::finished, m_processor, &QObject::deleteLater);
+    connect(this, &ResponsePanel::processResponse, m_processor, &ResponseProcessor::process);
+    connect(m_processor, &ResponseProcessor::finished, this, &ResponsePanel::onResponseProcessed);
+    m_processorThread->start();
+}
+
+ResponsePanel::~ResponsePanel()
+{
+    m_processorThread->quit();
+    m_processorThread->wait();
+    delete m_streamDecoder;
 }
 
 void ResponsePanel::setupUI()
@@ -50,9 +65,11 @@ void ResponsePanel::setupUI()
     bodyTabs->addTab(m_bodyTextEdit, "Pretty");
     
     // JSON tree view
-    m_jsonTreeWidget = new QTreeWidget();
-    m_jsonTreeWidget->setHeaderLabel("JSON Structure");
-    bodyTabs->addTab(m_jsonTreeWidget, "JSON");
+    m_jsonTreeModel = new JsonTreeModel(this);
+    m_jsonTreeView = new QTreeView();
+    m_jsonTreeView->setModel(m_jsonTreeModel);
+    m_jsonTreeView->setUniformRowHeights(true);
+    bodyTabs->addTab(m_jsonTreeView, "JSON");
     
     // Raw body
     m_rawTextEdit = new QTextEdit();
@@ -68,148 +85,162 @@ void ResponsePanel::setupUI()
     m_headersTextEdit->setFont(font);
     m_responseTabs->addTab(m_headersTextEdit, "Headers");
     
+    // Timing tab
+    m_timingTextEdit = new QTextEdit();
+    m_timingTextEdit->setReadOnly(true);
+    m_timingTextEdit->setFont(font);
+    m_responseTabs->addTab(m_timingTextEdit, "Timing");
+    
     mainLayout->addWidget(m_responseTabs);
 }
 
-void ResponsePanel::displayResponse(const QString &response, int statusCode, 
-                                  qint64 responseTime, const QString &headers)
+void ResponsePanel::beginResponse()
 {
-    // Update status information
-    updateStatusInfo(statusCode, responseTime, response);
-    
-    // Display headers
-    m_headersTextEdit->setPlainText(headers);
+    clearResponse();
+    m_statusLabel->setText("Status: Receiving...");
     
-    // Display raw response
-    m_rawTextEdit->setPlainText(response);
-    
-    // Try to format as JSON if possible
-    formatJsonResponse(response);
+    delete m_streamDecoder;
+    m_streamDecoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+    m_streamedBytes = 0;
+}
+
+void ResponsePanel::appendBodyChunk(const QByteArray &chunk)
+{
+    if (!m_streamDecoder || m_streamedBytes >= ResponseBuffer::DefaultMaxInMemorySize) {
+        return;
+    }
     
-    // Set the response in the pretty view
-    m_bodyTextEdit->setPlainText(response);
+    QByteArray shown = chunk.left(ResponseBuffer::DefaultMaxInMemorySize - m_streamedBytes);
+    m_streamedBytes += chunk.size();
+    m_sizeLabel->setText("Size: " + formatSize(m_streamedBytes));
     
-    // Try to pretty print JSON
-    QJsonParseError error;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(response.toUtf8(), &error);
-    if (error.error == QJsonParseError::NoError) {
-        QString prettyJson = jsonDoc.toJson(QJsonDocument::Indented);
-        m_bodyTextEdit->setPlainText(prettyJson);
-    }
+    // Appended at the end without moving the user's scroll position
+    QTextCursor cursor(m_rawTextEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(m_streamDecoder->toUnicode(shown));
 }
 
-void ResponsePanel::clearResponse()
+void ResponsePanel::displayResponse(const HttpResponse &response)
 {
+    // A new response replaces any previously spilled body
+    m_spilledBody = response.isSpilled() ? response.bodyBuffer() : ResponseBuffer();
+    delete m_streamDecoder;
+    m_streamDecoder = nullptr;
+    
+    // Update status information
+    updateStatusInfo(response.statusCode(), response.responseTimeMs());
+    
+    // Display headers and timing
+    m_headersTextEdit->setPlainText(response.headersText());
+    displayTiming(response.timing());
+    
     m_bodyTextEdit->clear();
-    m_headersTextEdit->clear();
-    m_rawTextEdit->clear();
-    m_jsonTreeWidget->clear();
-    m_statusLabel->setText("Status: Ready");
-    m_timeLabel->setText("Time: -");
+    m_jsonTreeModel->clear();
+    
+    // Only the preview of a spilled body is in memory; parsing it as JSON
+    // would only report an error, so every view shows the notice instead
+    if (m_spilledBody.isSpilled()) {
+        ++m_generation;
+        showSpilledBodyNotice();
+        return;
+    }
+    
+    // The body views are filled in once the processor has parsed the body;
+    // the bytes are shared with the processor thread, not copied. The raw
+    // view keeps the streamed text until then.
     m_sizeLabel->setText("Size: -");
+    if (response.isNetworkError()) {
+        emit processResponse(++m_generation, QString("Network Error: %1").arg(response.errorString()).toUtf8());
+    } else {
+        emit processResponse(++m_generation, response.body());
+    }
 }
 
-void ResponsePanel::formatJsonResponse(const QString &response)
+void ResponsePanel::onResponseProcessed(const ProcessedResponse &result)
 {
-    m_jsonTreeWidget->clear();
-    
-    QJsonParseError error;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(response.toUtf8(), &error);
-    
-    if (error.error != QJsonParseError::NoError) {
-        QTreeWidgetItem *errorItem = new QTreeWidgetItem(m_jsonTreeWidget);
-        errorItem->setText(0, "Invalid JSON: " + error.errorString());
+    if (result.generation != m_generation) {
         return;
     }
     
-    QTreeWidgetItem *rootItem = new QTreeWidgetItem(m_jsonTreeWidget);
+    m_bodyTextEdit->setPlainText(result.prettyText);
     
-    if (jsonDoc.isObject()) {
-        rootItem->setText(0, "Object");
-        addJsonObjectToTree(rootItem, jsonDoc.object());
-    } else if (jsonDoc.isArray()) {
-        rootItem->setText(0, "Array");
-        addJsonArrayToTree(rootItem, jsonDoc.array());
+    if (result.isJson) {
+        // Only the top level is expanded; deeper rows are built on demand
+        m_jsonTreeModel->setDocument(result.document);
+        m_jsonTreeView->expand(m_jsonTreeModel->index(0, 0));
     } else {
-        rootItem->setText(0, "Value: " + jsonDoc.toJson(QJsonDocument::Compact));
+        m_jsonTreeModel->setError(result.parseError);
     }
     
-    m_jsonTreeWidget->expandToDepth(2);
+    m_rawTextEdit->setPlainText(result.rawText);
+    m_sizeLabel->setText("Size: " + formatSize(result.sizeBytes));
 }
 
-void ResponsePanel::addJsonObjectToTree(QTreeWidgetItem *parent, const QJsonObject &obj)
+void ResponsePanel::displayTiming(const RequestTiming &timing)
 {
-    for (auto it = obj.begin(); it != obj.end(); ++it) {
-        QTreeWidgetItem *item = new QTreeWidgetItem(parent);
-        item->setText(0, it.key());
-        
-        const QJsonValue &value = it.value();
-        if (value.isObject()) {
-            item->setText(0, item->text(0) + " (Object)");
-            addJsonObjectToTree(item, value.toObject());
-        } else if (value.isArray()) {
-            item->setText(0, item->text(0) + " (Array)");
-            addJsonArrayToTree(item, value.toArray());
-        } else {
-            QString valueText;
-            switch (value.type()) {
-                case QJsonValue::String:
-                    valueText = "\"" + value.toString() + "\"";
-                    break;
-                case QJsonValue::Double:
-                    valueText = QString::number(value.toDouble());
-                    break;
-                case QJsonValue::Bool:
-                    valueText = value.toBool() ? "true" : "false";
-                    break;
-                case QJsonValue::Null:
-                    valueText = "null";
-                    break;
-                default:
-                    valueText = value.toVariant().toString();
-            }
-            item->setText(0, item->text(0) + ": " + valueText);
-        }
+    if (!timing.isValid()) {
+        m_timingTextEdit->clear();
+        return;
     }
+    
+    QString text;
+    text += QString("Queued:             %1\n").arg(formatDuration(timing.queuedNs()));
+    text += QString("DNS lookup:         %1\n").arg(formatDuration(timing.dnsLookupNs()));
+    text += QString("Connect + TLS:      %1\n").arg(formatDuration(timing.connectNs()));
+    text += QString("Time to first byte: %1\n").arg(formatDuration(timing.timeToFirstByteNs()));
+    text += QString("Download:           %1\n").arg(formatDuration(timing.downloadNs()));
+    text += QString("\nTotal:              %1\n").arg(formatDuration(timing.totalNs()));
+    m_timingTextEdit->setPlainText(text);
+}
+
+void ResponsePanel::showSpilledBodyNotice()
+{
+    m_sizeLabel->setText("Size: " + formatSize(m_spilledBody.size()));
+    
+    QString notice = QString("Response body is %1; only the first %2 are shown.\n"
+                             "The full body was saved to %3\n\n")
+                         .arg(formatSize(m_spilledBody.size()))
+                         .arg(formatSize(m_spilledBody.data().size()))
+                         .arg(m_spilledBody.fileName());
+    m_bodyTextEdit->setPlainText(notice + "The body is not formatted; the Raw tab shows the part that was loaded.");
+    m_jsonTreeModel->setError(notice.trimmed());
+    m_rawTextEdit->setPlainText(notice + QString::fromUtf8(m_spilledBody.data()));
 }
 
-void ResponsePanel::addJsonArrayToTree(QTreeWidgetItem *parent, const QJsonArray &array)
+QString ResponsePanel::formatDuration(qint64 nanoseconds) const
 {
-    for (int i = 0; i < array.size(); ++i) {
-        QTreeWidgetItem *item = new QTreeWidgetItem(parent);
-        item->setText(0, QString("[%1]").arg(i));
-        
-        const QJsonValue &value = array[i];
-        if (value.isObject()) {
-            item->setText(0, item->text(0) + " (Object)");
-            addJsonObjectToTree(item, value.toObject());
-        } else if (value.isArray()) {
-            item->setText(0, item->text(0) + " (Array)");
-            addJsonArrayToTree(item, value.toArray());
-        } else {
-            QString valueText;
-            switch (value.type()) {
-                case QJsonValue::String:
-                    valueText = "\"" + value.toString() + "\"";
-                    break;
-                case QJsonValue::Double:
-                    valueText = QString::number(value.toDouble());
-                    break;
-                case QJsonValue::Bool:
-                    valueText = value.toBool() ? "true" : "false";
-                    break;
-                case QJsonValue::Null:
-                    valueText = "null";
-                    break;
-                default:
-                    valueText = value.toVariant().toString();
-            }
-            item->setText(0, item->text(0) + ": " + valueText);
-        }
+    if (nanoseconds < 0) {
+        return "-";
     }
+    return QString("%1 ms").arg(nanoseconds / 1000000.0, 0, 'f', 3);
 }
 
-void ResponsePanel::updateStatusInfo(int statusCode, qint64 responseTime, const QString &response)
+QString ResponsePanel::formatSize(qint64 bytes) const
+{
+    if (bytes < 1024) {
+        return QString("%1 B").arg(bytes);
+    } else if (bytes < 1024 * 1024) {
+        return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void ResponsePanel::clearResponse()
+{
+    // Drop any result still in flight for the previous response
+    ++m_generation;
+    m_spilledBody = ResponseBuffer();
+    m_bodyTextEdit->clear();
+    m_headersTextEdit->clear();
+    m_timingTextEdit->clear();
+    m_rawTextEdit->clear();
+    m_jsonTreeModel->clear();
+    m_statusLabel->setText("Status: Ready");
+    m_timeLabel->setText("Time: -");
+    m_sizeLabel->setText("Size: -");
+}
+
+void ResponsePanel::updateStatusInfo(int statusCode, qint64 responseTime)
 {
     // Update status
     QString statusText = getStatusText(statusCode);
@@ -219,18 +250,6 @@ void ResponsePanel::updateStatusInfo(int statusCode, qint64 responseTime, const
     
     // Update time
     m_timeLabel->setText(QString("Time: %1 ms").arg(responseTime));
-    
-    // Update size
-    int sizeBytes = response.toUtf8().size();
-    QString sizeText;
-    if (sizeBytes < 1024) {
-        sizeText = QString("%1 B").arg(sizeBytes);
-    } else if (sizeBytes < 1024 * 1024) {
-        sizeText = QString("%.1f KB").arg(sizeBytes / 1024.0);
-    } else {
-        sizeText = QString("%.1f MB").arg(sizeBytes / (1024.0 * 1024.0));
-    }
-    m_sizeLabel->setText("Size: " + sizeText);
 }
 
 QString ResponsePanel::getStatusText(int statusCode)
@@ -5,7 +5,12 @@
 #include <QtWidgets/QTabWidget>
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QLabel>
-#include <QtWidgets/QTreeWidget>
+#include <QtWidgets/QTreeView>
+#include <QtCore/QThread>
+#include <QtCore/QTextCodec>
+#include "HttpResponse.h"
+#include "JsonTreeModel.h"
+#include "ResponseProcessor.h"
 
 class ResponsePanel : public QWidget
 {
@@ -13,19 +18,31 @@ class ResponsePanel : public QWidget
     
 public:
     explicit ResponsePanel(QWidget *parent = nullptr);
+    ~ResponsePanel();
     
 public slots:
-    void displayResponse(const QString &response, int statusCode, qint64 responseTime, const QString &headers);
+    // Clears the views for a request that has just been sent
+    void beginResponse();
+    // Shows body bytes in the raw view as they arrive
+    void appendBodyChunk(const QByteArray &chunk);
+    void displayResponse(const HttpResponse &response);
     void clearResponse();
     
+signals:
+    void processResponse(quint64 generation, const QByteArray &body);
+    
+private slots:
+    void onResponseProcessed(const ProcessedResponse &result);
+    
 private:
     void setupUI();
-    void formatJsonResponse(const QString &response);
-    void updateStatusInfo(int statusCode, qint64 responseTime, const QString &response);
-    void addJsonObjectToTree(QTreeWidgetItem *parent, const QJsonObject &obj);
-    void addJsonArrayToTree(QTreeWidgetItem *parent, const QJsonArray &array);
+    void displayTiming(const RequestTiming &timing);
+    void updateStatusInfo(int statusCode, qint64 responseTime);
+    void showSpilledBodyNotice();
     QString getStatusText(int statusCode);
     QString getStatusColorClass(int statusCode);
+    QString formatDuration(qint64 nanoseconds) const;
+    QString formatSize(qint64 bytes) const;
     
     // UI Components
     QLabel *m_statusLabel;
@@ -34,8 +51,24 @@ private:
     QTabWidget *m_responseTabs;
     QTextEdit *m_bodyTextEdit;
     QTextEdit *m_headersTextEdit;
+    QTextEdit *m_timingTextEdit;
     QTextEdit *m_rawTextEdit;
-    QTreeWidget *m_jsonTreeWidget;
+    QTreeView *m_jsonTreeView;
+    JsonTreeModel *m_jsonTreeModel;
+    
+    // Bodies are parsed and formatted on m_processorThread; results from
+    // responses older than m_generation are dropped
+    QThread *m_processorThread;
+    ResponseProcessor *m_processor;
+    quint64 m_generation;
+    
+    // Keeps the spill file of an oversized body alive while it is displayed
+    ResponseBuffer m_spilledBody;
+    
+    // Streamed chunks are decoded here so characters split across chunks
+    // survive; streaming stops at the in-memory preview size
+    QTextDecoder *m_streamDecoder;
+    qint64 m_streamedBytes;
 };
 
 #endif // RESPONSEPANEL_H
\ No newline at end of file
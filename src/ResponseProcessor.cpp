@@ -0,0 +1,28 @@
+#include "ResponseProcessor.h"
+#include <QtCore/QJsonParseError>
+
+ResponseProcessor::ResponseProcessor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ResponseProcessor::process(quint64 generation, const QByteArray &body)
+{
+    ProcessedResponse result;
+    result.generation = generation;
+    result.sizeBytes = body.size();
+    
+    // Parsed straight from the bytes; text is only decoded for display
+    QJsonParseError error;
+    result.document = QJsonDocument::fromJson(body, &error);
+    result.rawText = QString::fromUtf8(body);
+    if (error.error == QJsonParseError::NoError) {
+        result.isJson = true;
+        result.prettyText = QString::fromUtf8(result.document.toJson(QJsonDocument::Indented));
+    } else {
+        result.parseError = error.errorString();
+        result.prettyText = result.rawText;
+    }
+    
+    emit finished(result);
+}
\ No newline at end of file
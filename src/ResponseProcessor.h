@@ -0,0 +1,44 @@
+#ifndef RESPONSEPROCESSOR_H
+#define RESPONSEPROCESSOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMetaType>
+
+// Everything the response views need, prepared from a single pass over the
+// body. generation identifies the request the result belongs to.
+struct ProcessedResponse
+{
+    ProcessedResponse() : generation(0), sizeBytes(0), isJson(false) {}
+    
+    quint64 generation;
+    qint64 sizeBytes;
+    bool isJson;
+    QString parseError;
+    QJsonDocument document;
+    // Indented JSON, or the raw text when the body is not JSON
+    QString prettyText;
+    // The body decoded as UTF-8
+    QString rawText;
+};
+
+Q_DECLARE_METATYPE(ProcessedResponse)
+
+// Parses and formats response bodies. Lives on a worker thread; requests are
+// queued with process() and results come back through finished().
+class ResponseProcessor : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit ResponseProcessor(QObject *parent = nullptr);
+    
+public slots:
+    void process(quint64 generation, const QByteArray &body);
+    
+signals:
+    void finished(const ProcessedResponse &result);
+};
+
+#endif // RESPONSEPROCESSOR_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "RetryPolicy.h"
+#include "HttpResponse.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QStringList>
+#include <QtCore/QtMath>
+#include <algorithm>
+
+RetryPolicy::RetryPolicy()
+    : maxAttempts(1)
+    , retryStatusCodes({408, 429, 502, 503, 504})
+    , retryNetworkErrors(true)
+    , retryNonIdempotent(false)
+    , initialBackoffMs(200)
+    , multiplier(2.0)
+    , maxBackoffMs(10000)
+    , jitter(1.0)
+    , respectRetryAfter(true)
+    , maxRetryAfterMs(60000)
+{
+}
+
+RetryPolicy RetryPolicy::withAttempts(int maxAttempts)
+{
+    RetryPolicy policy;
+    policy.maxAttempts = qMax(1, maxAttempts);
+    return policy;
+}
+
+bool RetryPolicy::shouldRetry(const QString &method, const HttpResponse &response, int attempt) const
+{
+    if (attempt >= maxAttempts) {
+        return false;
+    }
+    
+    QString verb = method.toUpper();
+    if (!retryNonIdempotent && (verb == "POST" || verb == "PATCH")) {
+        return false;
+    }
+    
+    if (response.isNetworkError()) {
+        if (!retryNetworkErrors) {
+            return false;
+        }
+        switch (response.networkError()) {
+        case QNetworkReply::ConnectionRefusedError:
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::TemporaryNetworkFailureError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::ProxyConnectionClosedError:
+        case QNetworkReply::ProxyTimeoutError:
+        case QNetworkReply::UnknownNetworkError:
+            return true;
+        default:
+            // DNS, TLS and protocol errors will not go away on their own
+            return false;
+        }
+    }
+    
+    return retryStatusCodes.contains(response.statusCode());
+}
+
+qint64 RetryPolicy::backoffMs(const HttpResponse &response, int attempt) const
+{
+    if (respectRetryAfter) {
+        qint64 retryAfterMs = parseRetryAfter(response.header("Retry-After"));
+        if (retryAfterMs > maxRetryAfterMs) {
+            return -1;
+        }
+        if (retryAfterMs >= 0) {
+            return retryAfterMs;
+        }
+    }
+    
+    double backoff = qMin(double(maxBackoffMs), initialBackoffMs * qPow(multiplier, qMax(0, attempt - 1)));
+    double factor = 1.0 - qBound(0.0, jitter, 1.0) * QRandomGenerator::global()->generateDouble();
+    return qint64(backoff * factor);
+}
+
+qint64 RetryPolicy::parseRetryAfter(const QByteArray &value)
+{
+    QByteArray trimmed = value.trimmed();
+    if (trimmed.isEmpty()) {
+        return -1;
+    }
+    
+    bool ok = false;
+    qint64 seconds = trimmed.toLongLong(&ok);
+    if (ok) {
+        return seconds >= 0 ? seconds * 1000 : -1;
+    }
+    
+    // IMF-fixdate, e.g. "Wed, 21 Oct 2015 07:28:00 GMT"
+    QDateTime date = QLocale::c().toDateTime(QString::fromLatin1(trimmed), "ddd, dd MMM yyyy HH:mm:ss 'GMT'");
+    if (!date.isValid()) {
+        return -1;
+    }
+    date.setTimeSpec(Qt::UTC);
+    return qMax<qint64>(0, QDateTime::currentDateTimeUtc().msecsTo(date));
+}
+
+QString RetryPolicy::toText() const
+{
+    if (!isEnabled()) {
+        return "Retries: disabled";
+    }
+    
+    QList<int> codes = retryStatusCodes.values();
+    std::sort(codes.begin(), codes.end());
+    QStringList codeList;
+    for (int code : codes) {
+        codeList << QString::number(code);
+    }
+    
+    return QString("Retries: up to %1 attempts on %2%3. Backoff from %4 ms, x%5 per attempt up to %6 ms, "
+                   "with %7% jitter%8.")
+        .arg(maxAttempts)
+        .arg(codeList.isEmpty() ? QString("no status codes") : codeList.join(", "))
+        .arg(retryNetworkErrors ? " and transient network errors" : "")
+        .arg(initialBackoffMs)
+        .arg(multiplier)
+        .arg(maxBackoffMs)
+        .arg(qRound(jitter * 100))
+        .arg(respectRetryAfter ? "; Retry-After is honoured" : "");
+}
\ No newline at end of file
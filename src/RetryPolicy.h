@@ -0,0 +1,68 @@
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <QtCore/QString>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+#include <QtCore/QMetaType>
+#include <QtNetwork/QNetworkReply>
+#include "RequestTiming.h"
+
+class HttpResponse;
+
+// One attempt that was retried. Its timing covers that attempt alone, so
+// latency figures are never stretched by earlier failures or backoff.
+struct RequestAttempt
+{
+    RequestAttempt() : statusCode(0), backoffMs(0) {}
+    
+    int statusCode;
+    QString errorString;
+    RequestTiming timing;
+    // Wait before the next attempt was sent
+    qint64 backoffMs;
+};
+
+// When and how often RequestExecutor retries a request. The wait before
+// attempt n + 1 is initialBackoffMs * multiplier^(n - 1), capped at
+// maxBackoffMs, of which a random share given by jitter is dropped so that
+// clients failing together do not retry together. A Retry-After header
+// replaces the computed wait.
+class RetryPolicy
+{
+public:
+    // One attempt, i.e. retries disabled
+    RetryPolicy();
+    
+    // Up to maxAttempts attempts with the default backoff
+    static RetryPolicy withAttempts(int maxAttempts);
+    
+    bool isEnabled() const { return maxAttempts > 1; }
+    // attempt counts from 1
+    bool shouldRetry(const QString &method, const HttpResponse &response, int attempt) const;
+    // -1 when a Retry-After asks for a longer wait than maxRetryAfterMs
+    qint64 backoffMs(const HttpResponse &response, int attempt) const;
+    
+    // Delta-seconds or an HTTP date; -1 when missing or unparsable
+    static qint64 parseRetryAfter(const QByteArray &value);
+    
+    QString toText() const;
+    
+    int maxAttempts;
+    QSet<int> retryStatusCodes;
+    // Connection refused or reset, timeouts and similar transient failures
+    bool retryNetworkErrors;
+    // POST and PATCH are only retried when this is set
+    bool retryNonIdempotent;
+    int initialBackoffMs;
+    double multiplier;
+    int maxBackoffMs;
+    // 0 waits exactly the computed backoff; 1 waits anywhere up to it
+    double jitter;
+    bool respectRetryAfter;
+    int maxRetryAfterMs;
+};
+
+Q_DECLARE_METATYPE(RetryPolicy)
+
+#endif // RETRYPOLICY_H
\ No newline at end of file
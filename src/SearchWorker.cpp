@@ -0,0 +1,169 @@
+#include "SearchWorker.h"
+#include <QtCore/QStringList>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+namespace {
+const char *ConnectionName = "SearchConnection";
+const int ResultBatchSize = 50;
+}
+
+SearchWorker::SearchWorker(QObject *parent)
+    : QObject(parent)
+    , m_latestGeneration(0)
+{
+}
+
+SearchWorker::~SearchWorker()
+{
+    if (m_database.isValid()) {
+        m_database.close();
+        m_database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(ConnectionName);
+    }
+}
+
+QString SearchWorker::buildMatchQuery(const QString &text)
+{
+    // Quote each word so FTS5 operators in user input are taken literally
+    QStringList terms;
+    const QStringList words = text.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    for (QString word : words) {
+        word.replace('"', "\"\"");
+        terms << QString("\"%1\"*").arg(word);
+    }
+    return terms.join(' ');
+}
+
+bool SearchWorker::openDatabase(const QString &databasePath)
+{
+    if (m_database.isOpen() && databasePath == m_databasePath) {
+        return true;
+    }
+    
+    if (!m_database.isValid()) {
+        m_database = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+    }
+    m_database.close();
+    m_database.setDatabaseName(databasePath);
+    m_databasePath = databasePath;
+    
+    if (!m_database.open()) {
+        qWarning() << "Failed to open search database:" << m_database.lastError().text();
+        return false;
+    }
+    
+    m_profile.apply(m_database);
+    return true;
+}
+
+void SearchWorker::search(quint64 generation, const QString &databasePath, const QString &text, int limit)
+{
+    QString matchQuery = buildMatchQuery(text);
+    if (isStale(generation) || matchQuery.isEmpty() || !openDatabase(databasePath)) {
+        emit searchFinished(generation);
+        return;
+    }
+    
+    QSet<int> seenRequests;
+    bool completed = runQuery(generation, SearchResult::Request, R"(
+        SELECT r.id, r.collection_id, r.name, r.method, r.url,
+               snippet(requests_fts, -1, '[', ']', '...', 10)
+        FROM requests_fts
+        JOIN requests r ON r.id = requests_fts.rowid
+        WHERE requests_fts MATCH ?
+        ORDER BY rank
+        LIMIT ?
+    )", matchQuery, limit, seenRequests);
+    
+    // Newest history first; rowid order lets FTS5 stop after the limit
+    // instead of ranking every match in a large history
+    QSet<int> seenHistory;
+    if (completed) {
+        completed = runQuery(generation, SearchResult::History, R"(
+            SELECT h.id, h.status_code, h.created_at, h.method, h.url,
+                   snippet(history_fts, -1, '[', ']', '...', 10)
+            FROM history_fts
+            JOIN history h ON h.id = history_fts.rowid
+            WHERE history_fts MATCH ?
+            ORDER BY history_fts.rowid DESC
+            LIMIT ?
+        )", matchQuery, limit, seenHistory);
+    }
+    
+    // Response bodies are indexed once per distinct blob; the index is
+    // contentless, so these hits carry no snippet. One body can be shared by
+    // thousands of polling entries, so the limit is applied to blobs first
+    // and each blob contributes only its newest entry, found through
+    // idx_history_response_blob.
+    if (completed) {
+        runQuery(generation, SearchResult::History, R"(
+            SELECT h.id, h.status_code, h.created_at, h.method, h.url, ''
+            FROM (
+                SELECT rowid AS blob_id FROM response_blobs_fts
+                WHERE response_blobs_fts MATCH ?
+                ORDER BY rowid DESC
+                LIMIT ?
+            ) hits
+            JOIN history h ON h.id = (
+                SELECT MAX(id) FROM history WHERE response_blob_id = hits.blob_id
+            )
+            ORDER BY h.id DESC
+        )", matchQuery, limit, seenHistory);
+    }
+    
+    emit searchFinished(generation);
+}
+
+bool SearchWorker::runQuery(quint64 generation, SearchResult::Kind kind, const QString &sql,
+                            const QString &matchQuery, int limit, QSet<int> &seen)
+{
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(matchQuery);
+    query.addBindValue(limit);
+    
+    if (!query.exec()) {
+        qWarning() << "Search failed:" << query.lastError().text();
+        return true;
+    }
+    
+    QList<SearchResult> batch;
+    while (query.next()) {
+        if (isStale(generation)) {
+            return false;
+        }
+        
+        SearchResult result;
+        result.kind = kind;
+        result.id = query.value(0).toInt();
+        if (seen.contains(result.id)) {
+            continue;
+        }
+        seen.insert(result.id);
+        if (kind == SearchResult::Request) {
+            result.collectionId = query.value(1).toInt();
+            result.name = query.value(2).toString();
+        } else {
+            result.statusCode = query.value(1).toInt();
+            result.createdAt = query.value(2).toString();
+        }
+        result.method = query.value(3).toString();
+        result.url = query.value(4).toString();
+        result.snippet = query.value(5).toString().simplified();
+        batch.append(result);
+        
+        if (batch.size() >= ResultBatchSize) {
+            emit resultsReady(generation, batch);
+            batch.clear();
+        }
+    }
+    
+    if (!batch.isEmpty()) {
+        emit resultsReady(generation, batch);
+    }
+    return true;
+}
\ No newline at end of file
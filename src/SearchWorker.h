@@ -0,0 +1,78 @@
+#ifndef SEARCHWORKER_H
+#define SEARCHWORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QMetaType>
+#include <QtSql/QSqlDatabase>
+#include "StorageProfile.h"
+
+struct SearchResult
+{
+    enum Kind
+    {
+        Request,
+        History
+    };
+    
+    SearchResult() : kind(Request), id(0), collectionId(0), statusCode(0) {}
+    
+    Kind kind;
+    int id;
+    int collectionId;
+    int statusCode;
+    QString name;
+    QString method;
+    QString url;
+    // Matching text with the hit wrapped in [ ]
+    QString snippet;
+    QString createdAt;
+};
+
+Q_DECLARE_METATYPE(SearchResult)
+Q_DECLARE_METATYPE(QList<SearchResult>)
+
+// Runs full-text searches over requests and history on its own thread and
+// database connection. Results are posted in small batches as rows are read;
+// starting a new search abandons the previous one.
+class SearchWorker : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit SearchWorker(QObject *parent = nullptr);
+    ~SearchWorker();
+    
+    // Set before the worker is moved to its thread
+    void setStorageProfile(const StorageProfile &profile) { m_profile = profile; }
+    
+    // Thread-safe; lets a running search notice it has been superseded
+    void setLatestGeneration(quint64 generation) { m_latestGeneration.storeRelease(generation); }
+    
+    // Turns free text into an FTS5 query that prefix-matches every word
+    static QString buildMatchQuery(const QString &text);
+    
+public slots:
+    void search(quint64 generation, const QString &databasePath, const QString &text, int limit);
+    
+signals:
+    void resultsReady(quint64 generation, const QList<SearchResult> &results);
+    void searchFinished(quint64 generation);
+    
+private:
+    bool openDatabase(const QString &databasePath);
+    // Rows whose id is already in seen are skipped, so a hit found through
+    // both the url and the body index is reported once
+    bool runQuery(quint64 generation, SearchResult::Kind kind, const QString &sql,
+                  const QString &matchQuery, int limit, QSet<int> &seen);
+    bool isStale(quint64 generation) const { return generation != m_latestGeneration.loadAcquire(); }
+    
+    QSqlDatabase m_database;
+    QString m_databasePath;
+    StorageProfile m_profile;
+    QAtomicInteger<quint64> m_latestGeneration;
+};
+
+#endif // SEARCHWORKER_H
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "SettingsDialog.h"
+#include "DatabaseManager.h"
+#include "NetworkPool.h"
+#include "ConfigManager.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QSettings>
 #include <QtWidgets/QDialogButtonBox>
@@ -34,6 +37,7 @@ void SettingsDialog::setupUI()
     setupGeneralTab();
     setupAppearanceTab();
     setupDatabaseTab();
+    setupNetworkTab();
     
     // Dialog buttons
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
@@ -114,11 +118,79 @@ void SettingsDialog::setupDatabaseTab()
     pathLayout->addWidget(m_databaseInfoLabel);
     
     layout->addWidget(pathGroup);
+    
+    // History storage group
+    QGroupBox *storageGroup = new QGroupBox("History Storage");
+    QVBoxLayout *storageLayout = new QVBoxLayout(storageGroup);
+    
+    // Measured by the history compactor; until its first pass there is nothing to show
+    DatabaseManager &database = DatabaseManager::instance();
+    m_historyStorageLabel = new QLabel(database.hasResponseStorageStats()
+                                       ? database.responseStorageStats().toText()
+                                       : QString("Measuring history storage..."));
+    m_historyStorageLabel->setWordWrap(true);
+    storageLayout->addWidget(m_historyStorageLabel);
+    connect(&database, &DatabaseManager::responseStorageStatsChanged, this, [this](const ResponseStorageStats &stats) {
+        m_historyStorageLabel->setText(stats.toText());
+    });
+    
+    QPushButton *reclaimButton = new QPushButton("Reclaim Disk Space");
+    reclaimButton->setToolTip("Returns free pages to the file system in the background. The first time, "
+                              "the database file is rewritten once, which needs as much free space as the file.");
+    connect(reclaimButton, &QPushButton::clicked, this, [reclaimButton]() {
+        DatabaseManager::instance().reclaimHistorySpace();
+        reclaimButton->setEnabled(false);
+    });
+    storageLayout->addWidget(reclaimButton, 0, Qt::AlignLeft);
+    
+    layout->addWidget(storageGroup);
     layout->addStretch();
     
     m_tabWidget->addTab(m_databaseTab, "Database");
 }
 
+void SettingsDialog::setupNetworkTab()
+{
+    m_networkTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(m_networkTab);
+    
+    // Connection pool group
+    QGroupBox *poolGroup = new QGroupBox("Connection Pool");
+    QVBoxLayout *poolLayout = new QVBoxLayout(poolGroup);
+    
+    NetworkPool *pool = NetworkPool::instance();
+    QLabel *poolSettingsLabel = new QLabel(QString("HTTP/2: %1. Idle connections close after %2. "
+                                                   "Up to %3 requests per host at once, shared by request "
+                                                   "tabs, test runs and load tests.")
+        .arg(pool->isHttp2Allowed() ? "allowed" : "disabled")
+        .arg(pool->idleTimeout() > 0 ? QString("%1 s").arg(pool->idleTimeout()) : QString("the server's timeout"))
+        .arg(pool->maxConnectionsPerHost() > 0 ? QString::number(pool->maxConnectionsPerHost()) : QString("unlimited")));
+    poolSettingsLabel->setWordWrap(true);
+    poolLayout->addWidget(poolSettingsLabel);
+    
+    m_connectionStatsLabel = new QLabel(pool->stats().toText());
+    m_connectionStatsLabel->setWordWrap(true);
+    poolLayout->addWidget(m_connectionStatsLabel);
+    connect(pool, &NetworkPool::statsChanged, this, [this](const ConnectionPoolStats &stats) {
+        m_connectionStatsLabel->setText(stats.toText());
+    });
+    
+    layout->addWidget(poolGroup);
+    
+    // Retry group
+    QGroupBox *retryGroup = new QGroupBox("Retries");
+    QVBoxLayout *retryLayout = new QVBoxLayout(retryGroup);
+    
+    QLabel *retryLabel = new QLabel(ConfigManager::instance()->getRetryPolicy().toText());
+    retryLabel->setWordWrap(true);
+    retryLayout->addWidget(retryLabel);
+    
+    layout->addWidget(retryGroup);
+    layout->addStretch();
+    
+    m_tabWidget->addTab(m_networkTab, "Network");
+}
+
 QString SettingsDialog::getDatabasePath() const
 {
     return m_databasePathEdit->text();
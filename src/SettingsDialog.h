@@ -44,6 +44,7 @@ private:
     void setupGeneralTab();
     void setupAppearanceTab();
     void setupDatabaseTab();
+    void setupNetworkTab();
     
     // UI Components
     QTabWidget *m_tabWidget;
@@ -61,6 +62,11 @@ private:
     QPushButton *m_browseButton;
     QPushButton *m_resetPathButton;
     QLabel *m_databaseInfoLabel;
+    QLabel *m_historyStorageLabel;
+    
+    // Network tab
+    QWidget *m_networkTab;
+    QLabel *m_connectionStatsLabel;
     
     // Original values for cancel functionality
     QString m_originalDatabasePath;
@@ -0,0 +1,74 @@
+#include "StorageProfile.h"
+#include <QtCore/QStringList>
+#include <QtCore/QDebug>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+StorageProfile::StorageProfile()
+    : journalMode("WAL")
+    , synchronous("NORMAL")
+    , cacheSizeKiB(16 * 1024)
+    , mmapSize(256 * 1024 * 1024)
+    , tempStore("MEMORY")
+    , busyTimeoutMs(5000)
+{
+}
+
+StorageProfile StorageProfile::legacy()
+{
+    StorageProfile profile;
+    profile.journalMode = "DELETE";
+    profile.synchronous = "FULL";
+    profile.cacheSizeKiB = 2000;
+    profile.mmapSize = 0;
+    profile.tempStore = "DEFAULT";
+    profile.busyTimeoutMs = 0;
+    return profile;
+}
+
+bool StorageProfile::apply(QSqlDatabase &database) const
+{
+    // PRAGMA values cannot be bound, so only accept the documented keywords
+    static const QStringList journalModes = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+    static const QStringList synchronousModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    static const QStringList tempStores = {"DEFAULT", "FILE", "MEMORY"};
+    
+    QString mode = journalMode.toUpper();
+    QString sync = synchronous.toUpper();
+    QString temp = tempStore.toUpper();
+    if (!journalModes.contains(mode) || !synchronousModes.contains(sync) || !tempStores.contains(temp)) {
+        qWarning() << "Invalid storage profile:" << journalMode << synchronous << tempStore;
+        return false;
+    }
+    
+    QSqlQuery query(database);
+    
+    // journal_mode reports the mode actually in use; WAL is refused on
+    // some network file systems
+    if (!query.exec("PRAGMA journal_mode=" + mode) || !query.next()) {
+        qWarning() << "Failed to set journal mode:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toString().toUpper() != mode) {
+        qWarning() << "SQLite kept journal mode" << query.value(0).toString() << "instead of" << mode;
+    }
+    query.finish();
+    
+    const QStringList pragmas = {
+        "PRAGMA synchronous=" + sync,
+        QString("PRAGMA cache_size=-%1").arg(qMax(0, cacheSizeKiB)),
+        QString("PRAGMA mmap_size=%1").arg(qMax<qint64>(0, mmapSize)),
+        "PRAGMA temp_store=" + temp,
+        QString("PRAGMA busy_timeout=%1").arg(qMax(0, busyTimeoutMs))
+    };
+    
+    for (const QString &pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qWarning() << "Failed to apply" << pragma << ":" << query.lastError().text();
+            return false;
+        }
+        query.finish();
+    }
+    
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef STORAGEPROFILE_H
+#define STORAGEPROFILE_H
+
+#include <QtCore/QString>
+#include <QtSql/QSqlDatabase>
+
+// SQLite tuning applied to every connection the application opens. The
+// defaults use WAL so readers never block the history writer, and relax
+// fsyncs to commit boundaries (synchronous=NORMAL is durable in WAL mode
+// apart from the last transactions before a power loss).
+class StorageProfile
+{
+public:
+    StorageProfile();
+    
+    // SQLite's own defaults: rollback journal and an fsync on every commit
+    static StorageProfile legacy();
+    
+    // Runs the PRAGMAs on an open connection
+    bool apply(QSqlDatabase &database) const;
+    
+    // DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+    QString journalMode;
+    // OFF, NORMAL, FULL or EXTRA
+    QString synchronous;
+    // Page cache size in KiB
+    int cacheSizeKiB;
+    // Bytes of the database file to memory-map; 0 disables mmap
+    qint64 mmapSize;
+    // DEFAULT, FILE or MEMORY
+    QString tempStore;
+    // How long a connection retries when another one holds the write lock
+    int busyTimeoutMs;
+};
+
+#endif // STORAGEPROFILE_H
\ No newline at end of file
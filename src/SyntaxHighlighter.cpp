@@ -4,59 +4,159 @@
 JsonSyntaxHighlighter::JsonSyntaxHighlighter(QTextDocument *parent)
     : QSyntaxHighlighter(parent)
 {
-    HighlightingRule rule;
-
-    // JSON key format (quoted strings followed by colon)
+    // JSON keys (strings followed by a colon)
     keyFormat.setForeground(QColor(86, 156, 214)); // Light blue
     keyFormat.setFontWeight(QFont::Bold);
-    rule.pattern = QRegularExpression(QStringLiteral("\"[^\"]*\"(?=\\s*:)"));
-    rule.format = keyFormat;
-    highlightingRules.append(rule);
 
     // JSON string values
     stringFormat.setForeground(QColor(206, 145, 120)); // Light orange
-    rule.pattern = QRegularExpression(QStringLiteral("(?<=:)\\s*\"[^\"]*\""));
-    rule.format = stringFormat;
-    highlightingRules.append(rule);
 
     // JSON numbers
     numberFormat.setForeground(QColor(181, 206, 168)); // Light green
-    rule.pattern = QRegularExpression(QStringLiteral("\\b[+-]?\\d+(?:\\.\\d+)?(?:[eE][+-]?\\d+)?\\b"));
-    rule.format = numberFormat;
-    highlightingRules.append(rule);
 
     // JSON boolean values
     booleanFormat.setForeground(QColor(86, 156, 214)); // Light blue
     booleanFormat.setFontWeight(QFont::Bold);
-    rule.pattern = QRegularExpression(QStringLiteral("\\b(true|false)\\b"));
-    rule.format = booleanFormat;
-    highlightingRules.append(rule);
 
     // JSON null
     nullFormat.setForeground(QColor(156, 156, 156)); // Gray
     nullFormat.setFontWeight(QFont::Bold);
-    rule.pattern = QRegularExpression(QStringLiteral("\\bnull\\b"));
-    rule.format = nullFormat;
-    highlightingRules.append(rule);
 
     // JSON punctuation
     punctuationFormat.setForeground(QColor(220, 220, 170)); // Light yellow
-    rule.pattern = QRegularExpression(QStringLiteral("[{}\\[\\],:]"));
-    rule.format = punctuationFormat;
-    highlightingRules.append(rule);
 }
 
 void JsonSyntaxHighlighter::highlightBlock(const QString &text)
 {
-    foreach (const HighlightingRule &rule, highlightingRules) {
-        QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-        while (matchIterator.hasNext()) {
-            QRegularExpressionMatch match = matchIterator.next();
-            setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+    const int length = text.length();
+    int pos = 0;
+    setCurrentBlockState(NormalState);
+
+    // Finish a string left open by the previous block
+    if (previousBlockState() == InStringState) {
+        int end = stringEnd(text, 0);
+        if (end < 0) {
+            setFormat(0, length, stringFormat);
+            setCurrentBlockState(InStringState);
+            return;
+        }
+        setFormat(0, end, stringFormat);
+        pos = end;
+    }
+
+    while (pos < length) {
+        const QChar ch = text.at(pos);
+
+        if (ch == QLatin1Char('"')) {
+            int end = stringEnd(text, pos + 1);
+            if (end < 0) {
+                setFormat(pos, length - pos, stringFormat);
+                setCurrentBlockState(InStringState);
+                return;
+            }
+
+            // A string is a key when the next token on the line is a colon
+            int next = end;
+            while (next < length && text.at(next).isSpace()) {
+                ++next;
+            }
+            bool isKey = next < length && text.at(next) == QLatin1Char(':');
+            setFormat(pos, end - pos, isKey ? keyFormat : stringFormat);
+            pos = end;
+        } else if (ch.isDigit() || ch == QLatin1Char('-') || ch == QLatin1Char('+')) {
+            int end = numberEnd(text, pos);
+            if (end > pos) {
+                setFormat(pos, end - pos, numberFormat);
+                pos = end;
+            } else {
+                ++pos;
+            }
+        } else if (ch.isLetter()) {
+            int end = pos + 1;
+            while (end < length && (text.at(end).isLetterOrNumber() || text.at(end) == QLatin1Char('_'))) {
+                ++end;
+            }
+
+            QStringRef word = text.midRef(pos, end - pos);
+            if (word == QLatin1String("true") || word == QLatin1String("false")) {
+                setFormat(pos, end - pos, booleanFormat);
+            } else if (word == QLatin1String("null")) {
+                setFormat(pos, end - pos, nullFormat);
+            }
+            pos = end;
+        } else {
+            switch (ch.unicode()) {
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ',':
+            case ':':
+                setFormat(pos, 1, punctuationFormat);
+                break;
+            default:
+                break;
+            }
+            ++pos;
         }
     }
 }
 
+int JsonSyntaxHighlighter::stringEnd(const QString &text, int from)
+{
+    const int length = text.length();
+    for (int pos = from; pos < length; ++pos) {
+        const QChar ch = text.at(pos);
+        if (ch == QLatin1Char('\\')) {
+            ++pos;
+        } else if (ch == QLatin1Char('"')) {
+            return pos + 1;
+        }
+    }
+    return -1;
+}
+
+int JsonSyntaxHighlighter::numberEnd(const QString &text, int from)
+{
+    const int length = text.length();
+    int pos = from;
+
+    if (pos < length && (text.at(pos) == QLatin1Char('-') || text.at(pos) == QLatin1Char('+'))) {
+        ++pos;
+    }
+
+    int digitsStart = pos;
+    while (pos < length && text.at(pos).isDigit()) {
+        ++pos;
+    }
+    if (pos == digitsStart) {
+        return from;
+    }
+
+    // Fraction and exponent only count when they are followed by digits
+    if (pos + 1 < length && text.at(pos) == QLatin1Char('.') && text.at(pos + 1).isDigit()) {
+        pos += 2;
+        while (pos < length && text.at(pos).isDigit()) {
+            ++pos;
+        }
+    }
+
+    if (pos < length && (text.at(pos) == QLatin1Char('e') || text.at(pos) == QLatin1Char('E'))) {
+        int exponent = pos + 1;
+        if (exponent < length && (text.at(exponent) == QLatin1Char('-') || text.at(exponent) == QLatin1Char('+'))) {
+            ++exponent;
+        }
+        if (exponent < length && text.at(exponent).isDigit()) {
+            pos = exponent;
+            while (pos < length && text.at(pos).isDigit()) {
+                ++pos;
+            }
+        }
+    }
+
+    return pos;
+}
+
 XmlSyntaxHighlighter::XmlSyntaxHighlighter(QTextDocument *parent)
     : QSyntaxHighlighter(parent)
 {
@@ -6,6 +6,9 @@
 #include <QtGui/QTextCharFormat>
 #include <QtCore/QRegularExpression>
 
+// Highlights JSON with a single left-to-right scan per block. A string that
+// is still open at the end of a line is carried into the next block through
+// the block state.
 class JsonSyntaxHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
@@ -17,12 +20,16 @@ protected:
     void highlightBlock(const QString &text) override;
 
 private:
-    struct HighlightingRule
+    enum BlockState
     {
-        QRegularExpression pattern;
-        QTextCharFormat format;
+        NormalState = 0,
+        InStringState = 1
     };
-    QVector<HighlightingRule> highlightingRules;
+
+    // Position just past the closing quote, or -1 if the string is unterminated
+    static int stringEnd(const QString &text, int from);
+    // Position just past a number starting at from, or from if there is none
+    static int numberEnd(const QString &text, int from);
 
     QTextCharFormat keyFormat;
     QTextCharFormat stringFormat;
@@ -1,12 +1,15 @@
 #include "TestExplorer.h"
+#include "ConfigManager.h"
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QTreeWidgetItem>
+#include <QtWidgets/QInputDialog>
 #include <QtCore/QDateTime>
 #include <QtGui/QIcon>
 
 TestExplorer::TestExplorer(QWidget *parent)
     : QWidget(parent)
     , m_testRunner(new TestRunner(this))
+    , m_loadTester(new LoadTester(this))
     , m_updateTimer(new QTimer(this))
     , m_totalTests(0)
     , m_completedTests(0)
@@ -20,6 +23,10 @@ TestExplorer::TestExplorer(QWidget *parent)
     connect(m_testRunner, &TestRunner::testCompleted, this, &TestExplorer::onTestCompleted);
     connect(m_testRunner, &TestRunner::allTestsCompleted, this, &TestExplorer::onAllTestsCompleted);
     
+    // Connect load tester signals
+    connect(m_loadTester, &LoadTester::progress, this, &TestExplorer::onLoadTestProgress);
+    connect(m_loadTester, &LoadTester::finished, this, &TestExplorer::onLoadTestFinished);
+    
     // Connect tree selection
     connect(m_testTree, &QTreeWidget::itemSelectionChanged, this, &TestExplorer::onTestItemSelectionChanged);
     
@@ -45,12 +52,49 @@ void TestExplorer::setupUI()
     connect(m_runSelectedButton, &QPushButton::clicked, this, &TestExplorer::runSelectedTest);
     m_buttonLayout->addWidget(m_runSelectedButton);
     
+    m_cancelButton = new QPushButton("■ Cancel");
+    m_cancelButton->setToolTip("Abort the running tests");
+    m_cancelButton->setEnabled(false);
+    connect(m_cancelButton, &QPushButton::clicked, m_testRunner, &TestRunner::cancel);
+    m_buttonLayout->addWidget(m_cancelButton);
+    
+    m_loadTestButton = new QPushButton("⚡ Load Test");
+    m_loadTestButton->setToolTip("Send the selected test (or the whole suite) at a fixed rate");
+    connect(m_loadTestButton, &QPushButton::clicked, this, &TestExplorer::runLoadTest);
+    m_buttonLayout->addWidget(m_loadTestButton);
+    
     m_refreshButton = new QPushButton("🔄 Refresh");
     connect(m_refreshButton, &QPushButton::clicked, this, &TestExplorer::refreshTests);
     m_buttonLayout->addWidget(m_refreshButton);
     
     m_buttonLayout->addStretch();
     
+    // Number of tests kept in flight when running the suite
+    m_buttonLayout->addWidget(new QLabel("Parallel:"));
+    m_concurrencySpin = new QSpinBox();
+    m_concurrencySpin->setRange(1, 256);
+    m_concurrencySpin->setToolTip("Number of tests run concurrently (1 = sequential)");
+    m_concurrencySpin->setValue(ConfigManager::instance()->getTestConcurrency());
+    m_testRunner->setMaxConcurrency(m_concurrencySpin->value());
+    connect(m_concurrencySpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &TestExplorer::onConcurrencyChanged);
+    m_buttonLayout->addWidget(m_concurrencySpin);
+    
+    // Deadline for each test; a hung endpoint fails its test instead of stalling the run
+    m_buttonLayout->addWidget(new QLabel("Timeout:"));
+    m_timeoutSpin = new QSpinBox();
+    m_timeoutSpin->setRange(0, 3600);
+    m_timeoutSpin->setSuffix(" s");
+    m_timeoutSpin->setSpecialValueText("None");
+    m_timeoutSpin->setToolTip("Seconds before a test is marked as timed out (0 = no timeout)");
+    m_timeoutSpin->setValue(ConfigManager::instance()->getTestTimeout());
+    m_testRunner->setDefaultTimeout(m_timeoutSpin->value() * 1000);
+    m_testRunner->setSuiteTimeout(ConfigManager::instance()->getSuiteTimeout() * 1000);
+    m_testRunner->setRetryPolicy(ConfigManager::instance()->getRetryPolicy());
+    connect(m_timeoutSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &TestExplorer::onTimeoutChanged);
+    m_buttonLayout->addWidget(m_timeoutSpin);
+    
     m_mainLayout->addLayout(m_buttonLayout);
     
     // Summary and progress
@@ -91,7 +135,7 @@ void TestExplorer::setupUI()
 }
 
 void TestExplorer::addTestFromRequest(int requestId, const QString &name, const QString &method,
-                                    const QString &url, const QString &headers, const QString &body)
+                                    const QString &url, const HttpHeaders &headers, const QString &body)
 {
     TestCase testCase;
     testCase.id = requestId;
@@ -151,6 +195,7 @@ void TestExplorer::runAllTests()
     
     m_runAllButton->setEnabled(false);
     m_runSelectedButton->setEnabled(false);
+    m_cancelButton->setEnabled(true);
     
     m_updateTimer->start();
     m_testRunner->runAllTests();
@@ -167,10 +212,71 @@ void TestExplorer::runSelectedTest()
     
     m_runAllButton->setEnabled(false);
     m_runSelectedButton->setEnabled(false);
+    m_cancelButton->setEnabled(true);
     
     m_testRunner->runTest(testId);
 }
 
+void TestExplorer::runLoadTest()
+{
+    if (m_loadTester->isRunning()) {
+        m_loadTester->stop();
+        return;
+    }
+    
+    QList<TestCase> tests;
+    QTreeWidgetItem *selectedItem = m_testTree->currentItem();
+    if (selectedItem) {
+        tests << m_testRunner->getTest(selectedItem->data(0, Qt::UserRole).toInt());
+    } else {
+        tests = m_testRunner->getTests();
+    }
+    
+    if (tests.isEmpty()) {
+        return;
+    }
+    
+    bool ok;
+    LoadTestOptions options;
+    options.requestsPerSecond = QInputDialog::getDouble(this, "Load Test", "Target requests per second:",
+                                                        options.requestsPerSecond, 0.1, 100000.0, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    
+    options.durationSeconds = QInputDialog::getInt(this, "Load Test", "Duration (seconds):",
+                                                   options.durationSeconds, 1, 3600, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    
+    m_runAllButton->setEnabled(false);
+    m_runSelectedButton->setEnabled(false);
+    m_loadTestButton->setText("■ Stop Load Test");
+    m_summaryLabel->setText(QString("Load test running at %1 req/s...").arg(options.requestsPerSecond));
+    
+    m_loadTester->setTests(tests);
+    m_loadTester->start(options);
+}
+
+void TestExplorer::onLoadTestProgress(qint64 sentRequests, qint64 completedRequests, qint64 errorCount)
+{
+    m_summaryLabel->setText(QString("Load test: %1 sent, %2 completed, %3 errors")
+                           .arg(sentRequests).arg(completedRequests).arg(errorCount));
+}
+
+void TestExplorer::onLoadTestFinished(const LoadTestReport &report)
+{
+    m_runAllButton->setEnabled(true);
+    m_runSelectedButton->setEnabled(true);
+    m_loadTestButton->setText("⚡ Load Test");
+    
+    m_summaryLabel->setText(QString("Load test completed: %1 req/s, %2% errors")
+                           .arg(report.throughput(), 0, 'f', 1)
+                           .arg(report.errorRate() * 100.0, 0, 'f', 2));
+    m_detailsText->setPlainText(report.toText());
+}
+
 void TestExplorer::refreshTests()
 {
     // This would typically reload tests from the database
@@ -185,8 +291,8 @@ void TestExplorer::onTestStarted(int testId)
 
 void TestExplorer::onTestCompleted(int testId, bool passed)
 {
-    TestCase::Status status = passed ? TestCase::Passed : TestCase::Failed;
-    updateTestItem(testId, status);
+    // Failed, timed out or cancelled
+    updateTestItem(testId, m_testRunner->getTest(testId).status);
     
     m_completedTests++;
     if (passed) {
@@ -205,6 +311,7 @@ void TestExplorer::onAllTestsCompleted(int totalTests, int passedTests, int fail
     
     m_runAllButton->setEnabled(true);
     m_runSelectedButton->setEnabled(true);
+    m_cancelButton->setEnabled(false);
     
     m_totalTests = totalTests;
     m_passedTests = passedTests;
@@ -228,6 +335,18 @@ void TestExplorer::onTestItemSelectionChanged()
     showTestDetails(testCase);
 }
 
+void TestExplorer::onConcurrencyChanged(int concurrency)
+{
+    m_testRunner->setMaxConcurrency(concurrency);
+    ConfigManager::instance()->setTestConcurrency(concurrency);
+}
+
+void TestExplorer::onTimeoutChanged(int seconds)
+{
+    m_testRunner->setDefaultTimeout(seconds * 1000);
+    ConfigManager::instance()->setTestTimeout(seconds);
+}
+
 void TestExplorer::updateTestItem(int testId, TestCase::Status status)
 {
     for (int i = 0; i < m_testTree->topLevelItemCount(); ++i) {
@@ -244,7 +363,7 @@ void TestExplorer::updateTestItem(int testId, TestCase::Status status)
             // Color coding
             if (status == TestCase::Passed) {
                 item->setBackground(1, QColor(40, 167, 69, 50)); // Green tint
-            } else if (status == TestCase::Failed) {
+            } else if (status == TestCase::Failed || status == TestCase::TimedOut) {
                 item->setBackground(1, QColor(220, 53, 69, 50)); // Red tint
             } else if (status == TestCase::Running) {
                 item->setBackground(1, QColor(255, 193, 7, 50)); // Yellow tint
@@ -286,6 +405,8 @@ QString TestExplorer::getStatusIcon(TestCase::Status status)
         case TestCase::Passed: return "✓";
         case TestCase::Failed: return "✗";
         case TestCase::Running: return "⟳";
+        case TestCase::TimedOut: return "⏱";
+        case TestCase::Cancelled: return "⊘";
         default: return "○";
     }
 }
@@ -296,6 +417,8 @@ QString TestExplorer::getStatusText(TestCase::Status status)
         case TestCase::Passed: return getStatusIcon(status) + " Passed";
         case TestCase::Failed: return getStatusIcon(status) + " Failed";
         case TestCase::Running: return getStatusIcon(status) + " Running";
+        case TestCase::TimedOut: return getStatusIcon(status) + " Timed Out";
+        case TestCase::Cancelled: return getStatusIcon(status) + " Cancelled";
         default: return getStatusIcon(status) + " Not Run";
     }
 }
@@ -316,8 +439,12 @@ void TestExplorer::showTestDetails(const TestCase &testCase)
         details += QString("Status Code: %1\n").arg(testCase.actualStatusCode);
     }
     
+    if (testCase.attempts > 1) {
+        details += QString("Attempts: %1\n").arg(testCase.attempts);
+    }
+    
     if (!testCase.headers.isEmpty()) {
-        details += QString("\nRequest Headers:\n%1\n").arg(testCase.headers);
+        details += QString("\nRequest Headers:\n%1\n").arg(testCase.headers.toText());
     }
     
     if (!testCase.body.isEmpty()) {
@@ -325,7 +452,7 @@ void TestExplorer::showTestDetails(const TestCase &testCase)
     }
     
     if (!testCase.actualResponse.isEmpty()) {
-        details += QString("\nResponse:\n%1\n").arg(testCase.actualResponse.left(500));
+        details += QString("\nResponse:\n%1\n").arg(QString::fromUtf8(testCase.actualResponse.left(500)));
         if (testCase.actualResponse.length() > 500) {
             details += "... (truncated)\n";
         }
@@ -10,8 +10,10 @@
 #include <QtWidgets/QProgressBar>
 #include <QtWidgets/QSplitter>
 #include <QtWidgets/QTextEdit>
+#include <QtWidgets/QSpinBox>
 #include <QtCore/QTimer>
 #include "TestRunner.h"
+#include "LoadTester.h"
 
 class TestExplorer : public QWidget
 {
@@ -21,17 +23,22 @@ public:
     explicit TestExplorer(QWidget *parent = nullptr);
     
     void addTestFromRequest(int requestId, const QString &name, const QString &method,
-                           const QString &url, const QString &headers, const QString &body);
+                           const QString &url, const HttpHeaders &headers, const QString &body);
     void clearTests();
     
 private slots:
     void runAllTests();
     void runSelectedTest();
+    void runLoadTest();
+    void onLoadTestProgress(qint64 sentRequests, qint64 completedRequests, qint64 errorCount);
+    void onLoadTestFinished(const LoadTestReport &report);
     void refreshTests();
     void onTestStarted(int testId);
     void onTestCompleted(int testId, bool passed);
     void onAllTestsCompleted(int totalTests, int passedTests, int failedTests);
     void onTestItemSelectionChanged();
+    void onConcurrencyChanged(int concurrency);
+    void onTimeoutChanged(int seconds);
     
 private:
     void setupUI();
@@ -46,7 +53,11 @@ private:
     QHBoxLayout *m_buttonLayout;
     QPushButton *m_runAllButton;
     QPushButton *m_runSelectedButton;
+    QPushButton *m_cancelButton;
+    QPushButton *m_loadTestButton;
     QPushButton *m_refreshButton;
+    QSpinBox *m_concurrencySpin;
+    QSpinBox *m_timeoutSpin;
     
     QLabel *m_summaryLabel;
     QProgressBar *m_progressBar;
@@ -57,6 +68,7 @@ private:
     
     // Test functionality
     TestRunner *m_testRunner;
+    LoadTester *m_loadTester;
     QTimer *m_updateTimer;
     
     // Statistics
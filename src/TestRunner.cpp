@@ -1,19 +1,65 @@
 #include "TestRunner.h"
-#include <QtCore/QUrl>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QRegularExpression>
-#include <QtCore/QDateTime>
-#include <QtNetwork/QNetworkRequest>
+#include <QtCore/QFile>
+#include <QtCore/QTextCodec>
+#include <QtCore/QScopedPointer>
+
+namespace {
+const qint64 SpillReadChunkSize = 4 * 1024 * 1024;
+
+// Case-insensitive search through a body spilled to disk, a chunk at a
+// time; the decoder carries split UTF-8 sequences over and the tail of
+// each chunk is kept so a match across a chunk boundary is still found
+bool spilledBodyContains(const ResponseBuffer &body, const QString &text, bool *readable)
+{
+    QFile file(body.fileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        *readable = false;
+        return false;
+    }
+    *readable = true;
+    
+    QScopedPointer<QTextDecoder> decoder(QTextCodec::codecForName("UTF-8")->makeDecoder());
+    QString window;
+    while (!file.atEnd()) {
+        const QByteArray chunk = file.read(SpillReadChunkSize);
+        if (chunk.isEmpty()) {
+            *readable = false;
+            return false;
+        }
+        window += decoder->toUnicode(chunk);
+        if (window.contains(text, Qt::CaseInsensitive)) {
+            return true;
+        }
+        window = window.right(text.size() - 1);
+    }
+    return false;
+}
+}
 
 TestRunner::TestRunner(QObject *parent)
     : QObject(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_currentTestIndex(-1)
+    , m_executor(new RequestExecutor(this))
+    , m_nextTestIndex(-1)
+    , m_lastTestIndex(-1)
+    , m_maxConcurrency(1)
+    , m_defaultTimeoutMs(DefaultTimeoutMs)
+    , m_suiteTimeoutMs(0)
     , m_isRunning(false)
-    , m_currentReply(nullptr)
-    , m_testStartTime(0)
 {
+    connect(m_executor, &RequestExecutor::finished, this, &TestRunner::onTestRequestFinished);
+    connect(m_executor, &RequestExecutor::slotAcquired, this, &TestRunner::onTestSlotAcquired);
+    connect(m_executor, &RequestExecutor::retrying, this, [this](int requestId, int nextAttempt, qint64) {
+        auto it = m_activeTests.find(requestId);
+        if (it != m_activeTests.end()) {
+            it->attempt = nextAttempt;
+        }
+    });
+    
+    m_suiteTimer.setSingleShot(true);
+    connect(&m_suiteTimer, &QTimer::timeout, this, &TestRunner::onSuiteTimeout);
 }
 
 void TestRunner::addTest(const TestCase &testCase)
@@ -21,6 +67,15 @@ void TestRunner::addTest(const TestCase &testCase)
     m_testCases.append(testCase);
 }
 
+void TestRunner::setMaxConcurrency(int maxConcurrency)
+{
+    m_maxConcurrency = qMax(1, maxConcurrency);
+    
+    if (m_isRunning) {
+        runNextTest();
+    }
+}
+
 void TestRunner::runAllTests()
 {
     if (m_isRunning) {
@@ -34,18 +89,17 @@ void TestRunner::runAllTests()
         m_testCases[i].actualStatusCode.clear();
         m_testCases[i].errorMessage.clear();
         m_testCases[i].responseTime = 0;
+        m_testCases[i].attempts = 0;
     }
     
-    m_currentTestIndex = 0;
-    m_isRunning = true;
-    
     if (m_testCases.isEmpty()) {
-        m_isRunning = false;
         emit allTestsCompleted(0, 0, 0);
         return;
     }
     
-    runNextTest();
+    m_nextTestIndex = 0;
+    m_lastTestIndex = m_testCases.size();
+    startRun();
 }
 
 void TestRunner::runTest(int testId)
@@ -67,22 +121,83 @@ void TestRunner::runTest(int testId)
         return;
     }
     
-    m_currentTestIndex = index;
+    // A timeout or cancellation from an earlier run must not stick
+    m_testCases[index].errorMessage.clear();
+    
+    m_nextTestIndex = index;
+    m_lastTestIndex = index + 1;
+    startRun();
+}
+
+void TestRunner::startRun()
+{
     m_isRunning = true;
+    if (m_suiteTimeoutMs > 0) {
+        m_suiteTimer.start(m_suiteTimeoutMs);
+    }
     
     runNextTest();
 }
 
-void TestRunner::clearTests()
+void TestRunner::cancel()
+{
+    if (!m_isRunning) {
+        return;
+    }
+    
+    stopRun(TestCase::Cancelled, "Cancelled");
+}
+
+void TestRunner::onSuiteTimeout()
+{
+    if (!m_isRunning) {
+        return;
+    }
+    
+    stopRun(TestCase::TimedOut, QString("Suite timed out after %1 ms").arg(m_suiteTimeoutMs));
+}
+
+void TestRunner::stopRun(TestCase::Status status, const QString &message)
 {
-    if (m_currentReply) {
-        m_currentReply->abort();
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
+    // Detach the run first so a testCompleted handler calling cancel()
+    // does not stop it twice
+    const QHash<int, ActiveTest> activeTests = m_activeTests;
+    int firstUnstarted = qMax(0, m_nextTestIndex);
+    int lastUnstarted = qMin(m_lastTestIndex, m_testCases.size());
+    m_activeTests.clear();
+    m_isRunning = false;
+    
+    for (auto it = activeTests.constBegin(); it != activeTests.constEnd(); ++it) {
+        m_executor->abort(it.key());
+        
+        TestCase &testCase = m_testCases[it->index];
+        testCase.status = status;
+        // Zero for tests still waiting for a slot
+        testCase.responseTime = it->timer.isValid() ? it->timer.elapsed() : 0;
+        testCase.attempts = it->attempt;
+        testCase.errorMessage = message;
+        emit testCompleted(testCase.id, false);
     }
     
+    // Tests that never started were not given the chance to time out
+    for (int i = firstUnstarted; i < lastUnstarted; ++i) {
+        TestCase &testCase = m_testCases[i];
+        testCase.status = TestCase::Cancelled;
+        testCase.errorMessage = status == TestCase::TimedOut ? "Not started before the suite timed out" : message;
+        emit testCompleted(testCase.id, false);
+    }
+    
+    finishRun();
+}
+
+void TestRunner::clearTests()
+{
+    abortActiveTests();
+    m_suiteTimer.stop();
+    
     m_testCases.clear();
-    m_currentTestIndex = -1;
+    m_nextTestIndex = -1;
+    m_lastTestIndex = -1;
     m_isRunning = false;
 }
 
@@ -98,132 +213,185 @@ TestCase TestRunner::getTest(int testId) const
 
 void TestRunner::runNextTest()
 {
-    if (m_currentTestIndex < 0 || m_currentTestIndex >= m_testCases.size()) {
-        // All tests completed
-        m_isRunning = false;
-        
-        int passedCount = 0;
-        int failedCount = 0;
-        for (const TestCase &testCase : m_testCases) {
-            if (testCase.status == TestCase::Passed) {
-                passedCount++;
-            } else if (testCase.status == TestCase::Failed) {
-                failedCount++;
-            }
+    // Keep up to m_maxConcurrency tests in flight
+    while (m_activeTests.size() < m_maxConcurrency && m_nextTestIndex >= 0
+           && m_nextTestIndex < m_lastTestIndex && m_nextTestIndex < m_testCases.size()) {
+        startTest(m_nextTestIndex++);
+    }
+    
+    if (m_activeTests.isEmpty()) {
+        finishRun();
+    }
+}
+
+void TestRunner::finishRun()
+{
+    // All tests completed
+    m_suiteTimer.stop();
+    m_isRunning = false;
+    m_nextTestIndex = -1;
+    m_lastTestIndex = -1;
+    
+    int passedCount = 0;
+    int failedCount = 0;
+    for (const TestCase &testCase : m_testCases) {
+        if (testCase.status == TestCase::Passed) {
+            passedCount++;
+        } else if (testCase.status == TestCase::Failed || testCase.status == TestCase::TimedOut) {
+            failedCount++;
         }
-        
-        emit allTestsCompleted(m_testCases.size(), passedCount, failedCount);
-        return;
     }
     
-    TestCase &currentTest = m_testCases[m_currentTestIndex];
+    emit allTestsCompleted(m_testCases.size(), passedCount, failedCount);
+}
+
+void TestRunner::startTest(int index)
+{
+    TestCase &currentTest = m_testCases[index];
     currentTest.status = TestCase::Running;
     
     emit testStarted(currentTest.id);
     
-    // Create network request
-    QNetworkRequest request;
-    request.setUrl(QUrl(currentTest.url));
-    request.setHeader(QNetworkRequest::UserAgentHeader, "ApiTester/1.0");
-    
-    // Set custom headers
-    if (!currentTest.headers.isEmpty()) {
-        QStringList headerLines = currentTest.headers.split('\n', Qt::SkipEmptyParts);
-        for (const QString &line : headerLines) {
-            int colonIndex = line.indexOf(':');
-            if (colonIndex > 0) {
-                QString headerName = line.left(colonIndex).trimmed();
-                QString headerValue = line.mid(colonIndex + 1).trimmed();
-                request.setRawHeader(headerName.toUtf8(), headerValue.toUtf8());
-            }
-        }
+    ActiveTest activeTest;
+    activeTest.index = index;
+    activeTest.attempt = 1;
+    
+    RetryPolicy retryPolicy = m_retryPolicy;
+    if (currentTest.maxAttempts > 0) {
+        retryPolicy.maxAttempts = currentTest.maxAttempts;
     }
     
-    // Send request based on method
-    QString method = currentTest.method.toUpper();
-    QByteArray requestBody = currentTest.body.toUtf8();
-    
-    m_testStartTime = QDateTime::currentMSecsSinceEpoch();
-    
-    if (method == "GET") {
-        m_currentReply = m_networkManager->get(request);
-    } else if (method == "POST") {
-        m_currentReply = m_networkManager->post(request, requestBody);
-    } else if (method == "PUT") {
-        m_currentReply = m_networkManager->put(request, requestBody);
-    } else if (method == "DELETE") {
-        m_currentReply = m_networkManager->deleteResource(request);
-    } else if (method == "PATCH") {
-        m_currentReply = m_networkManager->sendCustomRequest(request, "PATCH", requestBody);
-    } else if (method == "HEAD") {
-        m_currentReply = m_networkManager->head(request);
-    } else if (method == "OPTIONS") {
-        m_currentReply = m_networkManager->sendCustomRequest(request, "OPTIONS");
-    } else {
-        // Default to GET for unknown methods
-        m_currentReply = m_networkManager->get(request);
+    int requestId = sendTestRequest(m_executor, currentTest, retryPolicy);
+    m_activeTests.insert(requestId, activeTest);
+    
+    // Otherwise the deadline starts from onTestSlotAcquired()
+    if (!m_executor->isWaitingForSlot(requestId)) {
+        startTestDeadline(requestId);
+    }
+}
+
+void TestRunner::onTestSlotAcquired(int requestId)
+{
+    auto it = m_activeTests.find(requestId);
+    // Retries may wait for a slot again; the deadline covers all attempts
+    if (it != m_activeTests.end() && !it->timer.isValid()) {
+        startTestDeadline(requestId);
+    }
+}
+
+void TestRunner::startTestDeadline(int requestId)
+{
+    auto it = m_activeTests.find(requestId);
+    if (it == m_activeTests.end()) {
+        return;
+    }
+    it->timer.start();
+    
+    // Request ids are never reused, so a timer outliving its request is harmless
+    const TestCase &testCase = m_testCases[it->index];
+    int timeoutMs = testCase.timeoutMs > 0 ? testCase.timeoutMs : m_defaultTimeoutMs;
+    if (timeoutMs > 0) {
+        QTimer::singleShot(timeoutMs, this, [this, requestId]() { onTestTimeout(requestId); });
+    }
+}
+
+int TestRunner::sendTestRequest(RequestExecutor *executor, const TestCase &testCase,
+                                const RetryPolicy &retryPolicy)
+{
+    return executor->execute(testCase.method, testCase.url, testCase.headers, testCase.body, retryPolicy);
+}
+
+void TestRunner::abortActiveTests()
+{
+    m_executor->abortAll();
+    m_activeTests.clear();
+}
+
+void TestRunner::onTestTimeout(int requestId)
+{
+    if (!m_activeTests.contains(requestId)) {
+        return;
     }
     
-    connect(m_currentReply, &QNetworkReply::finished, this, &TestRunner::onTestReplyFinished);
+    ActiveTest activeTest = m_activeTests.take(requestId);
+    m_executor->abort(requestId);
+    
+    TestCase &currentTest = m_testCases[activeTest.index];
+    currentTest.status = TestCase::TimedOut;
+    currentTest.responseTime = activeTest.timer.elapsed();
+    currentTest.attempts = activeTest.attempt;
+    currentTest.errorMessage = QString("Timed out after %1 ms").arg(currentTest.responseTime);
+    
+    emit testCompleted(currentTest.id, false);
+    
+    // Refill the free slot or finish the run
+    runNextTest();
 }
 
-void TestRunner::onTestReplyFinished()
+void TestRunner::onTestRequestFinished(int requestId, const HttpResponse &response)
 {
-    if (!m_currentReply || m_currentTestIndex < 0 || m_currentTestIndex >= m_testCases.size()) {
+    if (!m_activeTests.contains(requestId)) {
         return;
     }
     
-    TestCase &currentTest = m_testCases[m_currentTestIndex];
+    int index = m_activeTests.take(requestId).index;
+    if (index < 0 || index >= m_testCases.size()) {
+        return;
+    }
     
-    qint64 responseTime = QDateTime::currentMSecsSinceEpoch() - m_testStartTime;
-    int statusCode = m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    QString response = QString::fromUtf8(m_currentReply->readAll());
+    TestCase &currentTest = m_testCases[index];
     
-    currentTest.responseTime = responseTime;
-    currentTest.actualStatusCode = QString::number(statusCode);
-    currentTest.actualResponse = response;
+    // Service time, like LoadTester reports; waiting for a slot is not the server's
+    currentTest.responseTime = response.timing().serviceMs();
+    currentTest.attempts = response.attemptCount();
+    currentTest.actualStatusCode = QString::number(qMax(0, response.statusCode()));
+    currentTest.actualResponse = response.body();
     
     // Handle network errors
-    if (m_currentReply->error() != QNetworkReply::NoError && statusCode == 0) {
-        currentTest.errorMessage = m_currentReply->errorString();
+    if (response.isNetworkError()) {
+        currentTest.errorMessage = response.errorString();
         currentTest.status = TestCase::Failed;
     } else {
         // Evaluate test result
-        bool passed = evaluateTestResult(currentTest, response, statusCode);
+        bool passed = evaluateTestResult(currentTest, response);
         currentTest.status = passed ? TestCase::Passed : TestCase::Failed;
     }
     
     emit testCompleted(currentTest.id, currentTest.status == TestCase::Passed);
     
-    m_currentReply->deleteLater();
-    m_currentReply = nullptr;
-    
-    // Move to next test or finish
-    if (m_currentTestIndex == -1) {
-        // Single test run
-        m_isRunning = false;
-        return;
-    }
-    
-    m_currentTestIndex++;
+    // Refill the free slot or finish the run
     runNextTest();
 }
 
-bool TestRunner::evaluateTestResult(const TestCase &testCase, const QString &response, int statusCode)
+bool TestRunner::evaluateTestResult(TestCase &testCase, const HttpResponse &response)
 {
     // Check status code if specified
     if (!testCase.expectedStatusCode.isEmpty()) {
         bool ok;
         int expectedStatus = testCase.expectedStatusCode.toInt(&ok);
-        if (ok && statusCode != expectedStatus) {
+        if (ok && response.statusCode() != expectedStatus) {
             return false;
         }
     }
     
     // Check response content if specified
     if (!testCase.expectedResponse.isEmpty()) {
-        // Simple string contains check for now
-        if (!response.contains(testCase.expectedResponse, Qt::CaseInsensitive)) {
+        // A spilled body holds only a preview in memory; search the whole
+        // body on disk rather than pass or fail on the preview
+        if (response.isSpilled()) {
+            bool readable = false;
+            bool found = spilledBodyContains(response.bodyBuffer(), testCase.expectedResponse, &readable);
+            if (!readable) {
+                testCase.errorMessage = QString("Response body truncated: only the first %1 of %2 bytes could be checked")
+                                            .arg(response.body().size())
+                                            .arg(response.size());
+                return false;
+            }
+            if (!found) {
+                return false;
+            }
+        } else if (!QString::fromUtf8(response.body()).contains(testCase.expectedResponse, Qt::CaseInsensitive)) {
+            // Simple string contains check for now; the body is only decoded here
             return false;
         }
     }
@@ -2,9 +2,13 @@
 #define TESTRUNNER_H
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
 #include <QtCore/QTimer>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkReply>
+#include <QtCore/QElapsedTimer>
+#include "HttpHeaders.h"
+#include "HttpResponse.h"
+#include "RequestExecutor.h"
+#include "RetryPolicy.h"
 
 class TestCase
 {
@@ -13,23 +17,33 @@ public:
         NotRun,
         Running,
         Passed,
-        Failed
+        Failed,
+        // Stopped by the test's or the suite's deadline
+        TimedOut,
+        // Stopped by TestRunner::cancel(), or never started before the suite deadline
+        Cancelled
     };
     
-    TestCase() : status(NotRun), responseTime(0) {}
+    TestCase() : timeoutMs(0), maxAttempts(0), status(NotRun), responseTime(0), attempts(0) {}
     
     int id;
     QString name;
     QString method;
     QString url;
-    QString headers;
+    HttpHeaders headers;
     QString body;
     QString expectedStatusCode;
     QString expectedResponse;
+    // 0 uses the runner's default timeout
+    int timeoutMs;
+    // 0 uses the runner's retry policy; otherwise overrides its attempt count
+    int maxAttempts;
     Status status;
-    QString actualResponse;
+    QByteArray actualResponse;
     QString actualStatusCode;
+    // Of the final attempt, so retries do not inflate it
     qint64 responseTime;
+    int attempts;
     QString errorMessage;
 };
 
@@ -45,27 +59,82 @@ public:
     void runTest(int testId);
     void clearTests();
     
+    // Number of tests kept in flight at once; 1 runs the suite sequentially
+    void setMaxConcurrency(int maxConcurrency);
+    int maxConcurrency() const { return m_maxConcurrency; }
+    bool isRunning() const { return m_isRunning; }
+    
+    // Deadline for each test that sets no timeout of its own; 0 waits forever
+    void setDefaultTimeout(int timeoutMs) { m_defaultTimeoutMs = qMax(0, timeoutMs); }
+    int defaultTimeout() const { return m_defaultTimeoutMs; }
+    // Deadline for a whole run, applied to runs started afterwards; 0 disables it
+    void setSuiteTimeout(int timeoutMs) { m_suiteTimeoutMs = qMax(0, timeoutMs); }
+    int suiteTimeout() const { return m_suiteTimeoutMs; }
+    
+    // Retries for tests that fail with a transient error; the timeout
+    // covers all attempts of a test, including the backoff between them
+    void setRetryPolicy(const RetryPolicy &policy) { m_retryPolicy = policy; }
+    RetryPolicy retryPolicy() const { return m_retryPolicy; }
+    
+    // Aborts the tests in flight and finishes the run; unfinished tests are
+    // marked Cancelled
+    void cancel();
+    
     QList<TestCase> getTests() const { return m_testCases; }
     TestCase getTest(int testId) const;
     
+    // Sends the HTTP request described by a test case and returns the executor's id
+    static int sendTestRequest(RequestExecutor *executor, const TestCase &testCase,
+                               const RetryPolicy &retryPolicy = RetryPolicy());
+    
 signals:
     void testStarted(int testId);
     void testCompleted(int testId, bool passed);
+    // Timed out tests count as failed; cancelled ones as neither
     void allTestsCompleted(int totalTests, int passedTests, int failedTests);
     
 private slots:
-    void onTestReplyFinished();
+    void onTestRequestFinished(int requestId, const HttpResponse &response);
+    void onTestSlotAcquired(int requestId);
+    void onTestTimeout(int requestId);
+    void onSuiteTimeout();
     
 private:
+    struct ActiveTest
+    {
+        int index;
+        // The attempt in flight or waiting to be sent
+        int attempt;
+        // Started when the request gets its per-host slot; the test's
+        // timeout does not count time spent waiting for one
+        QElapsedTimer timer;
+    };
+    
+    static const int DefaultTimeoutMs = 30000;
+    
+    void startRun();
     void runNextTest();
-    bool evaluateTestResult(const TestCase &testCase, const QString &response, int statusCode);
+    void startTest(int index);
+    void startTestDeadline(int requestId);
+    void finishRun();
+    void abortActiveTests();
+    // Marks in-flight tests with the given status and unstarted ones Cancelled
+    void stopRun(TestCase::Status status, const QString &message);
+    // Sets errorMessage when the body cannot be checked in full
+    bool evaluateTestResult(TestCase &testCase, const HttpResponse &response);
     
     QList<TestCase> m_testCases;
-    QNetworkAccessManager *m_networkManager;
-    int m_currentTestIndex;
+    RequestExecutor *m_executor;
+    // Keyed by executor request id
+    QHash<int, ActiveTest> m_activeTests;
+    QTimer m_suiteTimer;
+    RetryPolicy m_retryPolicy;
+    int m_nextTestIndex;
+    int m_lastTestIndex;
+    int m_maxConcurrency;
+    int m_defaultTimeoutMs;
+    int m_suiteTimeoutMs;
     bool m_isRunning;
-    QNetworkReply *m_currentReply;
-    qint64 m_testStartTime;
 };
 
 #endif // TESTRUNNER_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "UserManager.h"
+#include "ConfigManager.h"
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 #include <QtCore/QDebug>
@@ -37,6 +38,10 @@ bool UserManager::initializeUserDatabase()
         return false;
     }
     
+    if (!ConfigManager::instance()->getStorageProfile().apply(m_database)) {
+        qDebug() << "Continuing with SQLite default storage settings for the user database";
+    }
+    
     bool success = createUserTables();
     if (success) {
         seedDefaultUsers();
@@ -86,5 +86,8 @@ int main(int argc, char *argv[])
     config->saveWindowState(window.saveState());
     config->sync();
     
+    // Write out any history still queued on the background writer
+    DatabaseManager::instance().drainHistory();
+    
     return result;
 }
\ No newline at end of file